@@ -2,145 +2,46 @@
 // Iterated Local Search (ILS) para Maximum Independent Set (MISP)
 // Criterio de detención: TIEMPO (segundos).
 // Any-time behavior: imprime cada mejora (BEST ...) y el mejor final (FINAL_BEST ...).
+// BNB: ILS corto como cota inferior y luego branch-and-bound exacto (bnb.hpp) hasta -t;
+// informa además UPPER_BOUND / GAP y si el óptimo quedó probado.
 //
 // Formato de entrada (como tu ejemplo):
 //   - Primera línea: n
 //   - Luego: pares "u v" (0-based), aristas no dirigidas, hasta EOF.
 //   - Se permite más de un par por línea.
 //   - También acepta -i - para leer desde STDIN.
+//   - .gz / .zst / .zip se leen directamente (-i instancia.graph.gz), sin descomprimir aparte.
 //
 // Compilar (Linux):
-//   g++ -O3 -std=c++20 -Wall -Wextra -o IterativeLocalSearch IterativeLocalSearch.cpp
+//   g++ -O3 -march=native -std=c++20 -Wall -Wextra -pthread -o IterativeLocalSearch IterativeLocalSearch.cpp
 //
 // Ejecutar:
 //   ./IterativeLocalSearch ILS -i instancia.graph -t 10 --seed 1 --alpha 0.50 --perturb 3 --ls 4000 --verbose 1
+//   ./IterativeLocalSearch ILS -i instancia.graph -t 10 --threads 32 --restart 2000
+//   ./IterativeLocalSearch BNB -i instancia.graph -t 60 --warm 2
+//   ./IterativeLocalSearch ILS -i instancia.graph -t 60 --init ayer.sol --out hoy.sol
+//   ./IterativeLocalSearch ILS -i instancia.graph -t 3600 --checkpoint corrida.ckpt --resume
 
-#include <chrono>
 #include <cstdint>
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
-#include <numeric>
-#include <random>
+#include <memory>
 #include <string>
 #include <vector>
 #include <sstream>
 
-using namespace std;
-
-// -------------------- Timer --------------------
-struct Timer {
-    using Clock = std::chrono::steady_clock;
-    Clock::time_point t0;
-    Timer() : t0(Clock::now()) {}
-    void reset() { t0 = Clock::now(); }
-    double elapsed() const {
-        using namespace std::chrono;
-        return duration<double>(Clock::now() - t0).count();
-    }
-};
-
-// -------------------- Grafo (n; luego pares u v 0-based) --------------------
-struct Graph {
-    int n = 0;
-    long long m = 0;
-    vector<vector<int>> adj; // 0-indexado
-
-    // Lee el formato: primera línea N, luego pares u v (0-based) hasta EOF. Admite más de un par por línea.
-    bool load_n_then_pairs_zerobased(istream& in) {
-        adj.clear(); n=0; m=0;
-
-        // leer N (saltando comentarios tipo c/%/# y vacías)
-        auto is_comment_or_empty = [](const string& s){
-            for (char c: s) {
-                if (!isspace((unsigned char)c)) {
-                    return (c=='c' || c=='%' || c=='#'); 
-                }
-            }
-            return true;
-        };
-        auto trim = [](string& s){
-            size_t a = 0, b = s.size();
-            while (a<b && isspace((unsigned char)s[a])) ++a;
-            while (b>a && isspace((unsigned char)s[b-1])) --b;
-            s.assign(s.begin()+a, s.begin()+b);
-        };
-        auto split = [](const string& s){
-            vector<string> t; string cur;
-            for (char c: s) {
-                if (isspace((unsigned char)c)) {
-                    if (!cur.empty()) { t.push_back(cur); cur.clear(); }
-                } else cur.push_back(c);
-            }
-            if (!cur.empty()) t.push_back(cur);
-            return t;
-        };
-
-        string line;
-        int N = 0;
-        while (getline(in, line)) {
-            trim(line);
-            if (line.empty() || is_comment_or_empty(line)) continue;
-            try { N = stoi(line); } catch (...) { return false; }
-            break;
-        }
-        if (N <= 0) return false;
-
-        adj.assign(N, {});
+#include "graph.hpp"
+#include "bnb.hpp"
+#include "checkpoint.hpp"
+#include "greedy.hpp"
+#include "ils.hpp"
+#include "reduce.hpp"
+#include "solution.hpp"
 
-        // leer pares hasta EOF
-        while (getline(in, line)) {
-            trim(line);
-            if (line.empty() || is_comment_or_empty(line)) continue;
-            auto tok = split(line);
-            for (size_t i=0; i+1<tok.size(); i+=2) {
-                int u, v;
-                try { u = stoi(tok[i]); v = stoi(tok[i+1]); }
-                catch (...) { continue; }
-                if (u>=0 && v>=0 && u<N && v<N && u!=v) {
-                    adj[u].push_back(v);
-                    adj[v].push_back(u);
-                }
-            }
-        }
-        // normalizar y contar m
-        long long twice = 0;
-        for (int i=0;i<N;++i) {
-            auto &L = adj[i];
-            sort(L.begin(), L.end());
-            L.erase(unique(L.begin(), L.end()), L.end());
-            twice += (long long)L.size();
-        }
-        n = N; m = twice / 2;
-        return true;
-    }
-
-    bool load(const string& path) {
-        if (path == "-") {
-            return load_n_then_pairs_zerobased(cin);
-        } else {
-            ifstream in(path);
-            if (!in) return false;
-            return load_n_then_pairs_zerobased(in);
-        }
-    }
-
-    bool is_independent(const vector<int>& S) const {
-        vector<char> mark(n, 0);
-        for (int u : S) {
-            if (mark[u]) return false;
-            for (int v : adj[u]) mark[v] = 1;
-        }
-        return true;
-    }
-
-    bool are_adjacent(int u, int v) const {
-        const auto& L = adj[u];
-        return binary_search(L.begin(), L.end(), v);
-    }
-};
+using namespace std;
 
 // -------------------- CLI Options --------------------
 struct Options {
@@ -156,6 +57,26 @@ struct Options {
     int perturb_k = 3;     // fuerza de perturbación
     int ls_iters = 2000;   // tope iteraciones en búsqueda local
     int verbose = 0;
+    GraphBackend backend = GraphBackend::Auto;
+    int threads = 1;       // walkers ILS en paralelo
+    int restart = 0;       // iteraciones sin mejora antes de reiniciar desde la élite (0 = nunca)
+    bool adaptive = false; // perturbación y aceptación reactivas
+    int adapt_window = 100;
+    bool rcl_residual = false;   // construcción: RCL por grado residual
+    int target = -1;       // parar al alcanzar este tamaño (-1 = sin objetivo)
+    long long max_iters = 0;   // por walker (0 = sin tope)
+    long long stagnation = 0;  // iteraciones sin mejora del walker antes de parar (0 = nunca)
+    bool cache = false;    // usar/escribir instancia.graph.csr
+    bool reduce = false;   // kernelizar antes de la búsqueda
+    VertexOrder relabel = VertexOrder::None;   // reetiquetado para localidad (relabel.hpp)
+    double warm = -1.0;    // BNB: segundos de ILS previo (< 0 = 10% de -t)
+    string trace_path;     // traza por iteración (trace.hpp); vacío = sin traza
+    string init_path;      // solución de arranque (solution.hpp) o "greedy"; vacío = construct()
+    string out_path;       // archivo para la mejor solución (ids originales)
+    string checkpoint_path;   // checkpoints periódicos (checkpoint.hpp); vacío = sin
+    double checkpoint_every = kCheckpointEvery;
+    bool resume = false;   // seguir desde checkpoint_path si existe
+    size_t trace_cap = 1 << 20;   // eventos por walker
 };
 
 static void print_usage() {
@@ -163,11 +84,49 @@ static void print_usage() {
       "Uso:\n"
       "  misp_ils <Metaheuristica> -i <instancia|-> -t <tiempoSegundos>\n"
       "            [--seed S] [--alpha A] [--perturb K] [--ls I] [--verbose 0/1]\n"
+      "            [--backend auto|csr|bits|comp] [--threads N] [--restart R] [--cache]\n"
+      "            [--reduce] [--relabel none|degree|rcm|cluster] [--warm W] [--trace archivo[.csv]] [--trace-cap N]\n"
+      "            [--adaptive] [--adapt-window W] [--rcl static|residual]\n"
+      "            [--target V] [--max-iters I] [--stagnation N]\n"
+      "            [--init archivo|greedy] [--out archivo]\n"
+      "            [--checkpoint archivo] [--checkpoint-every S] [--resume]\n"
       "\n"
       "  Formato de instancia: primera línea N; luego pares 'u v' 0-based hasta EOF.\n"
-      "  Use -i - para leer desde STDIN (ej: unzip -p ... | ./misp_ils -i -).\n"
+      "  Use -i - para leer desde STDIN. .gz, .zst y .zip se leen directamente\n"
+      "  (-i instancia.graph.gz), descomprimiendo en paralelo con el parseo.\n"
+      "  --backend: representación del grafo; auto usa matriz de bits si la densidad es alta\n"
+      "             (y el complemento si además n es grande); comp guarda solo el complemento.\n"
+      "  --threads: N walkers ILS (semillas seed, seed+1, ...; perturb/alpha variados) que\n"
+      "             comparten el mejor global. --restart R: un walker sin mejora en R\n"
+      "             iteraciones reinicia desde la mejor solución global (0 = nunca).\n"
+      "  --cache: guarda el grafo normalizado en <instancia>.csr y lo reutiliza mientras\n"
+      "           el .graph no cambie (tamaño/mtime). -i también acepta un .csr directo.\n"
+      "  --reduce: aplica reducciones exactas (grado 0/1/2, dominación, gemelos) y busca\n"
+      "            solo en el kernel; BEST/FINAL_BEST ya cuentan los vértices fijados.\n"
+      "  --relabel: renumera los vértices (del kernel) antes de buscar para que los vecinos\n"
+      "             queden cerca en memoria: degree (grado ascendente), rcm (Cuthill-McKee\n"
+      "             inverso) o cluster (comunidades por propagación de etiquetas).\n"
+      "  --adaptive: k de perturbación y aceptación de empates según el estancamiento: cada\n"
+      "              W iteraciones sin mejora (--adapt-window, 100) k sube hasta min(4K, |S|/2);\n"
+      "              con k en el tope 4 ventanas más, salta a la élite con un kick aleatorio.\n"
+      "  --rcl: la RCL de la construcción toma los alpha * candidatos de menor grado en G\n"
+      "         (static, por defecto) o de menor grado entre los candidatos que quedan (residual).\n"
+      "  Parada: lo primero entre -t, --target V (tamaño alcanzado; para todos los walkers),\n"
+      "          --max-iters I y --stagnation N (iteraciones de un walker sin mejorar).\n"
+      "  --init: arranca los walkers desde una solución guardada (ids del grafo original; si\n"
+      "          no es independiente se repara) o desde el greedy determinista (greedy).\n"
+      "  --out: escribe la mejor solución (ids originales, uno por línea) al terminar.\n"
+      "  --checkpoint: guarda el estado de los walkers cada --checkpoint-every segundos (60)\n"
+      "                sin frenar la búsqueda, y al terminar. Con --resume, si el archivo\n"
+      "                existe la corrida sigue desde ahí (mismos parámetros e instancia); con\n"
+      "                --threads 1 y parada por iteraciones el resultado es idéntico al de\n"
+      "                una corrida sin cortes.\n"
+      "  --warm: (BNB) segundos de ILS para la cota inferior inicial; por defecto 10% de -t.\n"
+      "  --trace: un evento por iteración y walker (tiempo, |S|, movimientos de LS,\n"
+      "           perturbación, aceptación, mejoras); .csv = texto, otro = binario.\n"
+      "           --trace-cap: eventos guardados por walker (los más recientes).\n"
       "\n"
-      "Metaheurísticas: ILS\n";
+      "Metaheurísticas: ILS, BNB (exacto; n <= 32768)\n";
 }
 
 Options parse_args(int argc, char** argv) {
@@ -185,6 +144,34 @@ Options parse_args(int argc, char** argv) {
         else if (a == "--perturb" && need(i))o.perturb_k = stoi(argv[++i]);
         else if (a == "--ls" && need(i))     o.ls_iters = stoi(argv[++i]);
         else if (a == "--verbose" && need(i))o.verbose = stoi(argv[++i]);
+        else if (a == "--threads" && need(i))o.threads = stoi(argv[++i]);
+        else if (a == "--restart" && need(i))o.restart = stoi(argv[++i]);
+        else if (a == "--adaptive")          o.adaptive = true;
+        else if (a == "--adapt-window" && need(i)) o.adapt_window = stoi(argv[++i]);
+        else if (a == "--rcl" && need(i)) {
+            string r = argv[++i];
+            if (r != "static" && r != "residual") { o.error = "--rcl debe ser static o residual"; return o; }
+            o.rcl_residual = r == "residual";
+        }
+        else if (a == "--target" && need(i)) o.target = stoi(argv[++i]);
+        else if (a == "--max-iters" && need(i)) o.max_iters = stoll(argv[++i]);
+        else if (a == "--stagnation" && need(i)) o.stagnation = stoll(argv[++i]);
+        else if (a == "--cache")             o.cache = true;
+        else if (a == "--reduce")            o.reduce = true;
+        else if (a == "--relabel" && need(i)) {
+            if (!parse_vertex_order(argv[++i], o.relabel)) { o.error = "--relabel debe ser none, degree, rcm o cluster"; return o; }
+        }
+        else if (a == "--warm" && need(i))   o.warm = stod(argv[++i]);
+        else if (a == "--trace" && need(i))  o.trace_path = argv[++i];
+        else if (a == "--init" && need(i))   o.init_path = argv[++i];
+        else if (a == "--out" && need(i))    o.out_path = argv[++i];
+        else if (a == "--checkpoint" && need(i)) o.checkpoint_path = argv[++i];
+        else if (a == "--checkpoint-every" && need(i)) o.checkpoint_every = stod(argv[++i]);
+        else if (a == "--resume")            o.resume = true;
+        else if (a == "--trace-cap" && need(i)) o.trace_cap = stoull(argv[++i]);
+        else if (a == "--backend" && need(i)) {
+            if (!parse_backend(argv[++i], o.backend)) { o.error = "--backend debe ser auto, csr, bits o comp"; return o; }
+        }
         else {
             
         }
@@ -194,195 +181,188 @@ Options parse_args(int argc, char** argv) {
     if (o.time_limit <= 0)       { o.error = "Tiempo -t debe ser > 0"; return o; }
     if (o.alpha < 0.0) o.alpha = 0.0;
     if (o.alpha > 1.0) o.alpha = 1.0;
+    if (o.threads < 1) o.threads = 1;
+    if (o.trace_cap < 1) o.trace_cap = 1;
+    if (o.warm < 0) o.warm = 0.1 * o.time_limit;
+    if (o.resume && o.checkpoint_path.empty()) { o.error = "--resume necesita --checkpoint <archivo>"; return o; }
+    if (!o.checkpoint_path.empty() && o.meta != "ILS") { o.error = "--checkpoint solo con ILS"; return o; }
+    if (o.checkpoint_every <= 0) { o.error = "--checkpoint-every debe ser > 0"; return o; }
+    o.warm = min(o.warm, o.time_limit);
 
     o.ok = true;
     return o;
 }
 
-// -------------------- ILS para MISP --------------------
-struct ILS_MIS {
-    const Graph& G;
-    std::mt19937_64& rng;
-    double alpha;   // controla el tamaño de RCL
-    int perturb_k;  // fuerza perturbación
-    int ls_iters;   // tope de LS
-    int verbose;
-
-    // any-time
-    int best_val = -1;
-    double best_time = 0.0;
-    vector<int> best_set;
-
-    ILS_MIS(const Graph& g, std::mt19937_64& r, double a, int pk, int lsi, int v)
-        : G(g), rng(r), alpha(a), perturb_k(pk), ls_iters(lsi), verbose(v) {}
-
-    // Construcción Greedy aleatoria con RCL por grado (ascendente).
-    vector<int> construct() {
-        vector<int> order(G.n);
-        iota(order.begin(), order.end(), 0);
-        sort(order.begin(), order.end(),
-             [&](int a, int b){ return G.adj[a].size() < G.adj[b].size(); });
-
-        vector<char> forbidden(G.n, 0);
-        vector<int> S; S.reserve(G.n);
-
-        while (true) {
-            vector<int> cand;
-            cand.reserve(G.n);
-            for (int u : order) if (!forbidden[u]) cand.push_back(u);
-            if (cand.empty()) break;
-
-            int rcl = max(1, (int)ceil(alpha * (double)cand.size()));
-            rcl = min(rcl, (int)cand.size());
-            uniform_int_distribution<int> pick(0, rcl - 1);
-            int u = cand[pick(rng)];
-
-            S.push_back(u);
-            forbidden[u] = 1;
-            for (int v : G.adj[u]) forbidden[v] = 1;
+// -------------------- main --------------------
+template <class Graph>
+int solve(const Graph& G, const Options& opt, const Reduction& R) {
+    if (opt.verbose) {
+        cerr << "# Vertices: " << R.n0 << "  Edges: " << R.m0 << "\n";
+        if (opt.reduce) {
+            cerr << "# Reduccion: kernel " << G.n << " vertices (" << fixed << setprecision(1)
+                 << (R.n0 ? 100.0 * G.n / R.n0 : 0.0) << "%), " << G.m << " aristas ("
+                 << (R.m0 ? 100.0 * G.m / R.m0 : 0.0) << "%)  fijados " << R.offset
+                 << "  [incluidos " << R.included << ", plegados " << R.folded2
+                 << ", gemelos " << R.folded_twins << ", dominados " << R.dominated << "]  "
+                 << setprecision(6) << R.seconds << " s\n";
         }
-        return S;
+        cerr << "# Backend: " << Graph::backend_name << "  Memoria: "
+             << fixed << setprecision(2) << G.memory_bytes() / 1048576.0 << " MB\n";
     }
 
-    // Búsqueda local: 1-add repetidamente y luego intentos 2-por-1.
-    void local_search(vector<int>& S) {
-        vector<char> inS(G.n, 0);
-        for (int u : S) inS[u] = 1;
-
-        // conflicts[u] = vecinos en S
-        vector<int> conflicts(G.n, 0);
-        for (int u = 0; u < G.n; ++u) {
-            int c = 0;
-            for (int v : G.adj[u]) if (inS[v]) ++c;
-            conflicts[u] = c;
-        }
-
-        auto can_add = [&](int u){ return !inS[u] && conflicts[u] == 0; };
-        auto add = [&](int u){
-            inS[u] = 1; S.push_back(u);
-            for (int v : G.adj[u]) conflicts[v]++;
-        };
-        auto remove = [&](int u){
-            inS[u] = 0;
-            for (int v : G.adj[u]) conflicts[v]--;
-        };
+    if (opt.meta == "BNB" && G.n > kBitGraphMaxN) {
+        cerr << "BNB: el kernel tiene " << G.n << " vertices (maximo " << kBitGraphMaxN
+             << "); pruebe con --reduce o use ILS\n";
+        return 1;
+    }
 
-        bool improved = true;
-        int it = 0;
-        // Fase 1: 1-add
-        while (improved && it < ls_iters) {
-            improved = false; ++it;
-            for (int u = 0; u < G.n; ++u) {
-                if (can_add(u)) {
-                    add(u);
-                    improved = true;
-                    break;
+    ILSParams p;
+    p.seed = opt.seed;
+    p.alpha = opt.alpha;
+    p.perturb_k = opt.perturb_k;
+    p.ls_iters = opt.ls_iters;
+    p.verbose = opt.verbose;
+    p.threads = opt.threads;
+    p.restart = opt.restart;
+    p.adaptive = opt.adaptive;
+    p.adapt_window = opt.adapt_window;
+    p.rcl_residual = opt.rcl_residual;
+    p.max_iters = opt.max_iters;
+    p.stagnation = opt.stagnation;
+    p.time_limit = opt.time_limit;
+
+    vector<int> init;
+    if (!opt.init_path.empty()) {
+        if (opt.init_path == "greedy") {
+            greedy(G, &init);
+        } else {
+            vector<int> S0;
+            string err;
+            if (!read_solution(opt.init_path, S0, err)) {
+                cerr << "Error en --init: " << err << "\n";
+                return 1;
+            }
+            for (int u : S0) {
+                if (u >= R.n0) {
+                    cerr << "Error en --init: el vertice " << u << " no existe (n = " << R.n0 << ")\n";
+                    return 1;
                 }
             }
+            init = R.project(S0);
         }
-
-        // Fase 2: 2-por-1 swaps
-        improved = true;
-        while (improved && it < ls_iters) {
-            improved = false; ++it;
-
-            int u_choice = -1, v_choice = -1, x_choice = -1;
-            for (int u = 0; u < G.n; ++u) {
-                if (inS[u] || conflicts[u] != 1) continue;
-                int xu = -1;
-                for (int v : G.adj[u]) if (inS[v]) { xu = v; break; }
-                if (xu < 0) continue;
-
-                for (int v = u + 1; v < G.n; ++v) {
-                    if (inS[v] || conflicts[v] != 1) continue;
-                    if (G.are_adjacent(u, v)) continue;
-                    int xv = -1;
-                    for (int w : G.adj[v]) if (inS[w]) { xv = w; break; }
-                    if (xv < 0) continue;
-
-                    if (xu == xv) { // mismo conflictivo en S
-                        u_choice = u; v_choice = v; x_choice = xu;
-                        break;
-                    }
-                }
-                if (u_choice != -1) break;
+        p.init = &init;
+        if (opt.verbose) cerr << "# Inicio desde " << opt.init_path << ": " << init.size() << " vertices en el kernel\n";
+    }
+    // Lo que debe coincidir para retomar: instancia (kernel), búsqueda y paradas.
+    unique_ptr<Checkpointer> ckpt;
+    CheckpointData resume;
+    if (!opt.checkpoint_path.empty()) {
+        ostringstream fp;
+        fp << "ILS n=" << R.n0 << " m=" << R.m0 << " kernel=" << G.n << "/" << G.m << " offset=" << R.offset
+           << " relabel=" << (int)opt.relabel << " seed=" << opt.seed << " alpha=" << opt.alpha
+           << " perturb=" << opt.perturb_k << " ls=" << opt.ls_iters << " threads=" << opt.threads
+           << " restart=" << opt.restart << " adaptive=" << opt.adaptive << "/" << opt.adapt_window
+           << " rcl=" << opt.rcl_residual << " t=" << opt.time_limit << " target=" << opt.target
+           << " max_iters=" << opt.max_iters << " stagnation=" << opt.stagnation;
+        if (opt.resume && ifstream(opt.checkpoint_path)) {
+            string err;
+            if (!read_checkpoint(opt.checkpoint_path, resume, err)) {
+                cerr << "Error en --resume: " << err << "\n";
+                return 1;
             }
-
-            if (u_choice != -1) {
-                remove(x_choice);
-                S.erase(find(S.begin(), S.end(), x_choice));
-                add(u_choice);
-                add(v_choice);
-                improved = true;
+            if (resume.fingerprint != fp.str()) {
+                cerr << "Error en --resume: el checkpoint es de otra corrida\n  checkpoint: "
+                     << resume.fingerprint << "\n  actual:     " << fp.str() << "\n";
+                return 1;
             }
+            p.resume = &resume;
+            if (opt.verbose)
+                cerr << "# Retomando " << opt.checkpoint_path << ": t=" << fixed << setprecision(3)
+                     << resume.elapsed << " s  mejor " << resume.inc_val + R.offset << "\n";
         }
-
-        // compactar S
-        vector<int> finalS; finalS.reserve(S.size());
-        for (int u = 0; u < G.n; ++u) if (inS[u]) finalS.push_back(u);
-        S.swap(finalS);
+        ckpt = make_unique<Checkpointer>(opt.checkpoint_path, fp.str(), opt.checkpoint_every, p.threads);
+        p.checkpoint = ckpt.get();
     }
 
-    // Perturbación: remover k al azar; reparación greedy (grado asc).
-    void perturb_and_repair(vector<int>& S) {
-        if (S.empty()) return;
-        shuffle(S.begin(), S.end(), rng);
-        int k = min<int>(perturb_k, (int)S.size());
-        S.resize((int)S.size() - k);
-
-        vector<char> inS(G.n, 0);
-        for (int u : S) inS[u] = 1;
-
-        vector<int> order(G.n);
-        iota(order.begin(), order.end(), 0);
-        sort(order.begin(), order.end(),
-             [&](int a, int b){ return G.adj[a].size() < G.adj[b].size(); });
+#if MISP_TRACE
+    unique_ptr<Trace> trace;
+    if (!opt.trace_path.empty()) {
+        trace = make_unique<Trace>(p.threads, opt.trace_cap);
+        p.trace = trace.get();
+    }
+#else
+    if (!opt.trace_path.empty()) cerr << "Aviso: compilado con MISP_TRACE=0, --trace se ignora\n";
+#endif
 
-        for (int u : order) {
-            if (inS[u]) continue;
-            bool ok = true;
-            for (int v : G.adj[u]) if (inS[v]) { ok = false; break; }
-            if (ok) { inS[u] = 1; S.push_back(u); }
+    Timer timer;
+    timer.reset();
+    Incumbent inc;
+    inc.base = R.offset;
+    if (opt.target >= 0) inc.target = max(0, opt.target - R.offset);
+    const bool bnb = opt.meta == "BNB";
+    if (bnb) p.time_limit = opt.warm;
+    int ub = -1;
+    if (G.n == 0) {
+        // Todo quedó resuelto por la reducción.
+        inc.val = 0;
+        cout << "BEST " << R.offset << " TIME " << fixed << setprecision(6) << 0.0 << "\n";
+        ub = 0;
+    } else {
+        if (p.time_limit > 0) run_ils_portfolio(G, p, timer, inc);
+        if (bnb) {
+            BnBSolver<Graph> B(G);
+            B.build();
+            int lb = max(0, inc.val.load());
+            vector<int> lb_set;
+            inc.copy_set(lb_set);
+            ub = B.run(timer, opt.time_limit, lb, lb_set, inc);
+            if (opt.verbose)
+                cerr << "# BNB: nodos " << B.nodes << (B.timed_out ? "  (tiempo agotado)" : "") << "\n";
         }
     }
 
-    // Bucle principal ILS con any-time y tope de tiempo
-    tuple<vector<int>, int, double> run(Timer& tim, double time_limit_sec) {
-        best_val = -1; best_time = 0.0; best_set.clear();
-
-        // Construcción inicial + LS
-        vector<int> S = construct();
-        if (!G.is_independent(S)) S.clear();
-        local_search(S);
-
-        // Reporte inicial
-        best_set = S; best_val = (int)S.size(); best_time = tim.elapsed();
-        cout << "BEST " << best_val << " TIME " << fixed << setprecision(6) << best_time << "\n";
-
-        uniform_real_distribution<double> U01(0.0, 1.0);
-        const double t_end = tim.elapsed() + time_limit_sec;
-
-        while (tim.elapsed() < t_end) {
-            vector<int> S2 = S;
-            perturb_and_repair(S2);
-            local_search(S2);
-
-            if ((int)S2.size() > (int)S.size() || (((int)S2.size() == (int)S.size()) && U01(rng) < 0.05)) {
-                S.swap(S2);
-            }
-
-            if ((int)S.size() > best_val) {
-                best_val = (int)S.size();
-                best_time = tim.elapsed();
-                best_set = S;
-                cout << "BEST " << best_val << " TIME " << fixed << setprecision(6) << best_time << "\n";
+    // La respuesta final se verifica siempre (solution.hpp; milisegundos incluso en los
+    // grafos grandes). Sobre el kernel: lift es exacto por construcción.
+    Timer vt;
+    const Verification ver = verify_solution(G, inc.set);
+    if (!ver.ok) {
+        cerr << "Error: la solucion final no es valida: " << ver.message() << "\n";
+        return 1;
+    }
+    if (opt.verbose)
+        cerr << "# Verificacion: " << ver.message() << "  " << fixed << setprecision(6) << vt.elapsed() << " s\n";
+    if (!opt.out_path.empty() || (opt.verbose && (!R.identity() || R.relabeled()))) {
+        vector<int> S = R.lift(inc.set);
+        if (opt.verbose && (!R.identity() || R.relabeled()))
+            cerr << "# Solucion en el grafo original: " << S.size() << " vertices\n";
+        if (!opt.out_path.empty()) {
+            ostringstream h;
+            h << "instancia " << opt.instance_path << "\ntamano " << S.size() << "  found_at " << fixed
+              << setprecision(6) << inc.time << "  seed " << opt.seed;
+            if (!write_solution(opt.out_path, S, h.str())) {
+                cerr << "No se pudo escribir " << opt.out_path << "\n";
+                return 1;
             }
         }
-        return {best_set, best_val, best_time};
     }
-};
+    cout << "FINAL_BEST " << inc.val.load() + R.offset << " FOUND_AT " << fixed << setprecision(6) << inc.time << "\n";
+    if (bnb) {
+        const int gap = ub - inc.val.load();
+        cout << "UPPER_BOUND " << ub + R.offset << " GAP " << gap << (gap == 0 ? " OPTIMAL" : " TIMEOUT") << "\n";
+    }
+#if MISP_TRACE
+    if (trace) {
+        if (!trace->write(opt.trace_path)) {
+            cerr << "No se pudo escribir la traza " << opt.trace_path << "\n";
+            return 1;
+        }
+        if (opt.verbose)
+            cerr << "# Traza: " << opt.trace_path << "  descartados " << trace->dropped() << "\n";
+    }
+#endif
+    return 0;
+}
 
-// -------------------- main --------------------
 int main(int argc, char** argv) {
     Options opt = parse_args(argc, argv);
     if (!opt.ok) {
@@ -390,28 +370,18 @@ int main(int argc, char** argv) {
         cerr << "Error: " << opt.error << "\n";
         return 1;
     }
-    if (opt.meta != "ILS") {
-        cerr << "Unsupported metaheuristic: " << opt.meta << " (only ILS supported)\n";
+    if (opt.meta != "ILS" && opt.meta != "BNB") {
+        cerr << "Unsupported metaheuristic: " << opt.meta << " (ILS or BNB)\n";
         return 1;
     }
 
-    Graph G;
-    if (!G.load(opt.instance_path)) {
+    int rc = 0;
+    bool loaded = with_reduced_graph(opt.instance_path, [&](const auto& G, const Reduction& R) {
+        rc = solve(G, opt, R);
+    }, opt.backend, 0, opt.cache, opt.reduce, opt.relabel);
+    if (!loaded) {
         cerr << "Error leyendo instancia: " << opt.instance_path << "\n";
         return 1;
     }
-    if (opt.verbose) {
-        cerr << "# Vertices: " << G.n << "  Edges: " << G.m << "\n";
-    }
-
-    std::mt19937_64 rng(opt.seed);
-    Timer timer;
-    timer.reset();
-
-    ILS_MIS solver(G, rng, opt.alpha, opt.perturb_k, opt.ls_iters, opt.verbose);
-    auto [best_set, best_val, best_t] = solver.run(timer, opt.time_limit);
-
-    
-    cout << "FINAL_BEST " << best_val << " FOUND_AT " << fixed << setprecision(6) << best_t << "\n";
-    return 0;
-}
+    return rc;
+}
\ No newline at end of file
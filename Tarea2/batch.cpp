@@ -0,0 +1,329 @@
+// batch.cpp
+// Runner por lotes: reemplaza el bucle de los run_*.sh (un proceso por instancia, glob de
+// patrones de nombre y parseo de stdout con awk/sed). Recorre una carpeta de .graph,
+// reparte las instancias en un pool de hilos con robo de trabajo, carga cada grafo una vez
+// y escribe directamente el CSV por instancia y el resumen por densidad.
+//
+// Compilar (Linux):
+//   g++ -O3 -march=native -std=c++20 -Wall -Wextra -pthread -o batch batch.cpp
+//
+// Ejecutar:
+//   ./batch det  -d new_1000_dataset -o resultados.csv -r resumen.csv
+//   ./batch rand -d new_3000_dataset --crit 0.7 --k 0.2 --seed 1
+//   ./batch ILS  -d new_1000_dataset -t 10 --alpha 0.5 --perturb 3 --ls 4000 --seed 1 -j 8
+//
+// Salida (mismas columnas que los scripts):
+//   det/rand: densidad,idx,solucion,tiempo,archivo  +  densidad,count,mean_best,std_best,mean_time,std_time
+//   ILS:      densidad,idx,final_best,found_at,archivo  +  densidad,avg_best,avg_found_at,count
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dataset.hpp"
+#include "graph.hpp"
+#include "greedy.hpp"
+#include "ils.hpp"
+#include "reduce.hpp"
+#include "solution.hpp"
+#include "stats.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// -------------------- CLI Options --------------------
+struct BatchOptions {
+    bool ok = false;
+    string error;
+
+    string solver;           // det | rand | ILS
+    string dir;
+    string out_csv;
+    string out_resumen;
+    int jobs = 0;            // hilos del pool (0 = hardware_concurrency)
+    GraphBackend backend = GraphBackend::Auto;
+    bool cache = false;      // usar/escribir <instancia>.csr
+    bool reduce = false;     // resolver sobre el kernel (reduce.hpp)
+    VertexOrder relabel = VertexOrder::None;   // reetiquetado para localidad (relabel.hpp)
+
+    uint64_t seed = 123456789ULL;
+    double crit = 0.7;       // rand
+    double k = 0.2;          // rand
+    ILSParams ils;           // ILS (ils.seed se toma de seed)
+    int target = -1;         // ILS: parar al alcanzar este valor (todas las instancias)
+    string targets_csv;      // ILS: objetivo por instancia desde un CSV de resultados
+};
+
+static void print_usage() {
+    cerr <<
+      "Uso:\n"
+      "  batch <det|rand|ILS> -d <carpeta> [-o resultados.csv] [-r resumen.csv] [-j hilos]\n"
+      "        [--backend auto|csr|bits|comp] [--seed S] [--cache] [--reduce]\n"
+      "        [--relabel none|degree|rcm|cluster]\n"
+      "        rand: [--crit C] [--k K]\n"
+      "        ILS:  [-t T] [--alpha A] [--perturb K] [--ls I] [--threads N] [--restart R]\n"
+      "              [--adaptive] [--adapt-window W] [--rcl static|residual]\n"
+      "              [--target V | --targets resultados.csv] [--max-iters I] [--stagnation N]\n"
+      "\n"
+      "  Toma los archivos <...>p0c<densidad>_<idx>.graph de la carpeta.\n"
+      "  -j: instancias en paralelo (por defecto, los núcleos disponibles).\n"
+      "  --cache: reutiliza <instancia>.csr (caché binaria) y la crea si falta o está vieja.\n"
+      "  --reduce: kernelización exacta previa; la solución informada es la del grafo original.\n"
+      "  --relabel: renumera los vértices por grado, RCM o comunidades antes de resolver (los\n"
+      "             greedy desempatan por id, así que det/rand pueden cambiar en empates).\n"
+      "  Con ILS, -t es el tiempo de cada instancia; conviene -j * --threads <= núcleos.\n"
+      "  ILS para antes de -t si alcanza el objetivo, si un walker llega a --max-iters o si\n"
+      "  pasa --stagnation iteraciones sin mejorar. --targets toma el objetivo de cada\n"
+      "  instancia de un CSV con columnas archivo y final_best (o solucion), p.ej. una corrida\n"
+      "  anterior más larga.\n";
+}
+
+BatchOptions parse_args(int argc, char** argv) {
+    BatchOptions o;
+    if (argc < 2) { o.error = "Faltan argumentos."; return o; }
+    o.solver = argv[1];
+    if (o.solver != "det" && o.solver != "rand" && o.solver != "ILS") {
+        o.error = "Solver debe ser det, rand o ILS"; return o;
+    }
+
+    auto need = [&](int i){ return i+1 < argc; };
+    for (int i = 2; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "-d" && need(i))            o.dir = argv[++i];
+        else if (a == "-o" && need(i))       o.out_csv = argv[++i];
+        else if (a == "-r" && need(i))       o.out_resumen = argv[++i];
+        else if (a == "-j" && need(i))       o.jobs = stoi(argv[++i]);
+        else if (a == "--seed" && need(i))   o.seed = stoull(argv[++i]);
+        else if (a == "--cache")             o.cache = true;
+        else if (a == "--reduce")            o.reduce = true;
+        else if (a == "--relabel" && need(i)) {
+            if (!parse_vertex_order(argv[++i], o.relabel)) { o.error = "--relabel debe ser none, degree, rcm o cluster"; return o; }
+        }
+        else if (a == "--crit" && need(i))   o.crit = stod(argv[++i]);
+        else if (a == "--k" && need(i))      o.k = stod(argv[++i]);
+        else if (a == "-t" && need(i))       o.ils.time_limit = stod(argv[++i]);
+        else if (a == "--alpha" && need(i))  o.ils.alpha = stod(argv[++i]);
+        else if (a == "--perturb" && need(i))o.ils.perturb_k = stoi(argv[++i]);
+        else if (a == "--ls" && need(i))     o.ils.ls_iters = stoi(argv[++i]);
+        else if (a == "--threads" && need(i))o.ils.threads = stoi(argv[++i]);
+        else if (a == "--restart" && need(i))o.ils.restart = stoi(argv[++i]);
+        else if (a == "--adaptive")          o.ils.adaptive = true;
+        else if (a == "--adapt-window" && need(i)) o.ils.adapt_window = stoi(argv[++i]);
+        else if (a == "--rcl" && need(i)) {
+            string r = argv[++i];
+            if (r != "static" && r != "residual") { o.error = "--rcl debe ser static o residual"; return o; }
+            o.ils.rcl_residual = r == "residual";
+        }
+        else if (a == "--target" && need(i)) o.target = stoi(argv[++i]);
+        else if (a == "--targets" && need(i))o.targets_csv = argv[++i];
+        else if (a == "--max-iters" && need(i)) o.ils.max_iters = stoll(argv[++i]);
+        else if (a == "--stagnation" && need(i)) o.ils.stagnation = stoll(argv[++i]);
+        else if (a == "--backend" && need(i)) {
+            if (!parse_backend(argv[++i], o.backend)) { o.error = "--backend debe ser auto, csr, bits o comp"; return o; }
+        }
+        else { o.error = "Argumento desconocido: " + a; return o; }
+    }
+
+    if (o.dir.empty()) { o.error = "Falta -d <carpeta>"; return o; }
+    if (o.ils.time_limit <= 0) { o.error = "Tiempo -t debe ser > 0"; return o; }
+    o.ils.alpha = min(1.0, max(0.0, o.ils.alpha));
+    o.ils.seed = o.seed;
+    if (o.jobs <= 0) o.jobs = max(1, (int)thread::hardware_concurrency());
+    if (o.out_csv.empty()) o.out_csv = "resultados_" + o.solver + ".csv";
+    if (o.out_resumen.empty()) o.out_resumen = "resumen_por_densidad_" + o.solver + ".csv";
+
+    o.ok = true;
+    return o;
+}
+
+// Lee un CSV de resultados (columnas archivo y final_best o solucion) y asigna a cada
+// instancia el valor de su fila, comparando por nombre de archivo.
+static bool load_targets(const string& path, vector<Instance>& L) {
+    ifstream in(path);
+    string line;
+    if (!in || !getline(in, line)) return false;
+    auto split = [](const string& s) {
+        vector<string> f;
+        stringstream ss(s);
+        string x;
+        while (getline(ss, x, ',')) f.push_back(x);
+        return f;
+    };
+    vector<string> head = split(line);
+    int c_file = -1, c_val = -1;
+    for (int i = 0; i < (int)head.size(); ++i) {
+        if (head[i] == "archivo") c_file = i;
+        if (head[i] == "final_best" || head[i] == "solucion") c_val = i;
+    }
+    if (c_file < 0 || c_val < 0) return false;
+    map<string, int> by_name;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        vector<string> f = split(line);
+        if ((int)f.size() <= max(c_file, c_val) || f[c_val] == "NA") continue;
+        int& v = by_name[fs::path(f[c_file]).filename().string()];
+        v = max(v, stoi(f[c_val]));
+    }
+    for (auto& in : L) {
+        auto it = by_name.find(fs::path(in.path).filename().string());
+        if (it != by_name.end()) in.target = it->second;
+    }
+    return true;
+}
+
+// -------------------- Ejecución de una instancia --------------------
+struct Result {
+    bool ok = false;
+    int best = 0;
+    double time = 0.0;       // det/rand: tiempo del greedy; ILS: found_at
+};
+
+// G es el kernel; R.offset suma los vértices que la reducción ya fijó.
+template <class Graph>
+Result solve_one(const Graph& G, const BatchOptions& o, const Reduction& R, int target) {
+    Result r;
+    r.ok = true;
+    r.best = R.offset;
+    if (G.n == 0) return r;
+    if (o.solver == "ILS") {
+        Timer timer;
+        timer.reset();
+        Incumbent inc;
+        inc.print = false;
+        if (target >= 0) inc.target = max(0, target - R.offset);
+        run_ils_portfolio(G, o.ils, timer, inc);
+        r.best += inc.val.load();
+        r.time = inc.time;
+        r.ok = verify_solution(G, inc.set).ok;   // una solución inválida queda como NA
+        return r;
+    }
+    auto start = chrono::high_resolution_clock::now();
+    if (o.solver == "det") {
+        r.best += greedy(G);
+    } else {
+        // Semilla fija por instancia: mismo resultado que solverRandom con esa semilla.
+        mt19937_64 gen(o.seed);
+        r.best += greedy_randomized(G, o.crit, o.k, gen);
+    }
+    auto end = chrono::high_resolution_clock::now();
+    r.time = chrono::duration<double>(end - start).count();
+    return r;
+}
+
+// -------------------- Resumen por densidad --------------------
+// std muestral (n - 1) con Welford, igual que estadisticas_por_densidad.
+struct DensityStats {
+    RunningStats best, time;
+};
+
+static void write_outputs(const BatchOptions& o, const vector<Instance>& L, const vector<Result>& R) {
+    const bool ils = o.solver == "ILS";
+    ofstream csv(o.out_csv);
+    csv << (ils ? "densidad,idx,final_best,found_at,archivo\n" : "densidad,idx,solucion,tiempo,archivo\n");
+
+    map<double, pair<string, DensityStats>> by_dens;
+    double sb = 0.0, stt = 0.0;
+    int c = 0;
+    for (size_t i = 0; i < L.size(); ++i) {
+        csv << L[i].densidad << "," << L[i].idx << ",";
+        if (!R[i].ok) { csv << "NA,NA," << L[i].path << "\n"; continue; }
+        csv << R[i].best << ",";
+        if (ils) csv << fixed << setprecision(6) << R[i].time << defaultfloat;
+        else     csv << R[i].time;
+        csv << "," << L[i].path << "\n";
+
+        auto& [name, st] = by_dens[stod(L[i].densidad)];
+        name = L[i].densidad;
+        st.best.add(R[i].best);
+        st.time.add(R[i].time);
+        sb += R[i].best; stt += R[i].time; c++;
+    }
+
+    ofstream res(o.out_resumen);
+    res << fixed << setprecision(6);
+    res << (ils ? "densidad,avg_best,avg_found_at,count\n"
+                : "densidad,count,mean_best,std_best,mean_time,std_time\n");
+    for (const auto& [d, e] : by_dens) {
+        const auto& [name, st] = e;
+        if (ils) {
+            res << name << "," << st.best.mean << "," << st.time.mean << "," << st.best.n << "\n";
+        } else {
+            res << name << "," << st.best.n << "," << st.best.mean << "," << st.best.stddev() << ","
+                << st.time.mean << "," << st.time.stddev() << "\n";
+        }
+    }
+
+    cout << "\n===== PROMEDIO GENERAL =====\n";
+    if (c > 0) {
+        cout << fixed << setprecision(6)
+             << (ils ? "AVG_FINAL_BEST=" : "AVG_SOL=") << sb / c
+             << (ils ? "  AVG_FOUND_AT=" : "  AVG_TIME=") << stt / c
+             << "  (count=" << c << ")\n";
+    } else {
+        cout << "Sin datos válidos.\n";
+    }
+    cout << "\nArchivos generados:\n - " << o.out_csv << "\n - " << o.out_resumen << "\n";
+}
+
+// -------------------- main --------------------
+int main(int argc, char** argv) {
+    BatchOptions o = parse_args(argc, argv);
+    if (!o.ok) {
+        print_usage();
+        cerr << "Error: " << o.error << "\n";
+        return 1;
+    }
+
+    vector<Instance> L = list_instances(o.dir);
+    if (L.empty()) {
+        cerr << "No se encontraron instancias en " << o.dir << "\n";
+        return 1;
+    }
+
+    if (o.target >= 0)
+        for (auto& in : L) in.target = o.target;
+    if (!o.targets_csv.empty() && !load_targets(o.targets_csv, L)) {
+        cerr << "No se pudo leer objetivos de " << o.targets_csv << "\n";
+        return 1;
+    }
+
+    const int T = max(1, min(o.jobs, (int)L.size()));
+    vector<int> by_size(L.size());
+    for (size_t i = 0; i < L.size(); ++i) by_size[i] = (int)i;
+    stable_sort(by_size.begin(), by_size.end(), [&](int a, int b) { return L[a].bytes > L[b].bytes; });
+    WorkStealingPool pool(T);
+    for (size_t i = 0; i < by_size.size(); ++i) pool.push((int)(i % T), by_size[i]);
+
+    vector<Result> R(L.size());
+    mutex log_mu;
+    atomic<int> done{0};
+    pool.run([&](int i) {
+        // Carga con un hilo: el paralelismo es entre instancias.
+        bool loaded = with_reduced_graph(L[i].path, [&](const auto& G, const Reduction& red) {
+            R[i] = solve_one(G, o, red, L[i].target);
+        }, o.backend, 1, o.cache, o.reduce, o.relabel);
+        lock_guard<mutex> lk(log_mu);
+        int k = ++done;
+        cerr << "[" << k << "/" << L.size() << "] " << L[i].path << " (densidad=" << L[i].densidad
+             << ", idx=" << L[i].idx << ") -> ";
+        if (!loaded)         cerr << "no se pudo leer\n";
+        else if (!R[i].ok)   cerr << "solucion invalida\n";
+        else                 cerr << R[i].best << "\n";
+    });
+
+    write_outputs(o, L, R);
+    return 0;
+}
@@ -0,0 +1,381 @@
+// bench.cpp
+// Benchmark reproducible de los núcleos del solver sobre grafos Erdős–Rényi sembrados.
+//
+// Para cada (n, p) de la grilla genera G(n, p) con la semilla dada, lo escribe como .graph
+// en un directorio temporal y mide por separado:
+//   load      lectura + normalización + backend (with_loaded_graph)
+//   greedy    greedy determinista (greedy.hpp)
+//   grand     greedy_randomized (crit 0.7, k 0.2)
+//   construct construcción aleatoria del ILS (ILS_MIS::construct)
+//   ls        local_search desde una construcción nueva
+//   perturb   perturb_and_repair + rollback sobre una solución ya optimizada
+//   ils       una iteración del ILS completo (corre --ils-time segundos de bucle y divide;
+//             construcción y LS inicial quedan fuera, ya las miden construct y ls)
+// Cada muestra es segundos por operación; se reportan mediana, p10, p90, mín, máx y
+// operaciones por segundo (1 / mediana). value es el tamaño de solución (m para load) y
+// sirve para ver si un cambio alteró el resultado además del tiempo.
+//
+// Compilar (Linux):
+//   g++ -O3 -march=native -std=c++20 -Wall -Wextra -pthread -o bench bench.cpp
+//
+// Ejecutar:
+//   ./bench -o base.json                                   (grilla completa 1000/2000/3000 x 0.1..0.9)
+//   ./bench --sizes 1000 --dens 0.1,0.5 --reps 9 -o nuevo.json
+//   ./bench --compare base.json nuevo.json [-o comparacion.json]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "graph.hpp"
+#include "greedy.hpp"
+#include "ils.hpp"
+#include "stats.hpp"
+
+using namespace std;
+using namespace chrono;
+
+struct BenchOptions {
+    vector<int> sizes = {1000, 2000, 3000};
+    vector<double> dens = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+    uint64_t seed = 1;
+    int reps = 5;
+    int blocks = 20;          // perturb: bloques de kPerturbBlock llamadas
+    double ils_time = 0.2;    // ils: segundos por muestra
+    GraphBackend backend = GraphBackend::Auto;
+    string out, label, tmp;
+    vector<string> compare;
+};
+
+constexpr int kPerturbBlock = 256;
+
+struct BenchResult {
+    int n = 0;
+    double p = 0.0;
+    string kernel;
+    int reps = 0;
+    double median = 0, p10 = 0, p90 = 0, min = 0, max = 0;
+    long long value = 0;
+};
+
+static BenchResult summarize(int n, double p, const string& kernel, vector<double> s, long long value) {
+    sort(s.begin(), s.end());
+    BenchResult r;
+    r.n = n; r.p = p; r.kernel = kernel; r.reps = (int)s.size(); r.value = value;
+    r.median = quantile(s, 0.5);
+    r.p10 = quantile(s, 0.1);
+    r.p90 = quantile(s, 0.9);
+    r.min = s.front();
+    r.max = s.back();
+    return r;
+}
+
+template <class F>
+static double time_once(F&& f) {
+    auto start = steady_clock::now();
+    f();
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+// -------------------- Generación --------------------
+// G(n, p) sembrado por (seed, n, p): el mismo grafo en cualquier máquina y build.
+static bool write_er_graph(const string& path, int n, double p, uint64_t seed) {
+    mt19937_64 rng(seed * 1000003ULL + (uint64_t)n * 1009ULL + (uint64_t)llround(p * 1000));
+    const uint64_t thr = p >= 1.0 ? UINT64_MAX : (uint64_t)(p * 18446744073709551616.0);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    string buf;
+    buf.reserve(1 << 20);
+    buf += to_string(n) + "\n";
+    char tmp[32];
+    for (int u = 0; u < n; ++u) {
+        for (int v = u + 1; v < n; ++v) {
+            if (rng() >= thr) continue;
+            int len = snprintf(tmp, sizeof tmp, "%d %d\n", u, v);
+            buf.append(tmp, len);
+        }
+        if (buf.size() > (1 << 20) - 64) { fwrite(buf.data(), 1, buf.size(), f); buf.clear(); }
+    }
+    fwrite(buf.data(), 1, buf.size(), f);
+    return fclose(f) == 0;
+}
+
+// -------------------- Núcleos --------------------
+template <class Graph>
+static void bench_kernels(const Graph& G, double p, const BenchOptions& o, vector<BenchResult>& out) {
+    const int n = G.n;
+    vector<double> s;
+    long long value = 0;
+
+    s.clear();
+    for (int r = 0; r < o.reps; ++r) s.push_back(time_once([&] { value = greedy(G); }));
+    out.push_back(summarize(n, p, "greedy", s, value));
+
+    s.clear();
+    mt19937_64 gen(o.seed);
+    for (int r = 0; r < o.reps; ++r) s.push_back(time_once([&] { value = greedy_randomized(G, 0.7, 0.2, gen); }));
+    out.push_back(summarize(n, p, "grand", s, value));
+
+    mt19937_64 rng(o.seed);
+    ILS_MIS<Graph> ils(G, rng, 0.30, 3, 2000, 0);
+    vector<int> S;
+
+    s.clear();
+    for (int r = 0; r < o.reps; ++r) s.push_back(time_once([&] { S = ils.construct(); }));
+    out.push_back(summarize(n, p, "construct", s, (long long)S.size()));
+
+    s.clear();
+    for (int r = 0; r < o.reps; ++r) {
+        S = ils.construct();
+        ils.st.reset(S);
+        s.push_back(time_once([&] { ils.local_search(); }));
+    }
+    ils.st.commit();
+    out.push_back(summarize(n, p, "ls", s, ils.st.size()));
+
+    // Sobre la última solución ya optimizada: cada llamada se deshace para medir siempre
+    // desde el mismo estado.
+    s.clear();
+    for (int b = 0; b < o.blocks; ++b) {
+        double t = time_once([&] {
+            for (int i = 0; i < kPerturbBlock; ++i) {
+                const size_t mark = ils.st.checkpoint();
+                ils.perturb_and_repair();
+                ils.st.rollback(mark);
+            }
+        });
+        s.push_back(t / kPerturbBlock);
+    }
+    out.push_back(summarize(n, p, "perturb", s, ils.st.size()));
+
+    s.clear();
+    value = 0;
+    for (int r = 0; r < o.reps; ++r) {
+        mt19937_64 wr(o.seed + (uint64_t)r);
+        ILS_MIS<Graph> w(G, wr, 0.30, 3, 2000, 0);
+        Timer tim;
+        Incumbent inc;
+        inc.print = false;
+        w.run(tim, o.ils_time, inc);
+        // run fija t_end = (fin de construcción + LS inicial) + ils_time: se cuenta solo el bucle.
+        const double loop_s = tim.elapsed() - (w.t_end - o.ils_time);
+        s.push_back(loop_s / (double)max(1LL, w.iters));
+        value = max<long long>(value, inc.val.load());
+    }
+    out.push_back(summarize(n, p, "ils", s, value));
+}
+
+// -------------------- JSON --------------------
+static void write_result_json(ostream& os, const BenchResult& r) {
+    os << "    {\"n\": " << r.n << ", \"p\": " << r.p << ", \"kernel\": \"" << r.kernel
+       << "\", \"reps\": " << r.reps << ", \"median\": " << r.median << ", \"p10\": " << r.p10
+       << ", \"p90\": " << r.p90 << ", \"min\": " << r.min << ", \"max\": " << r.max
+       << ", \"per_sec\": " << (r.median > 0 ? 1.0 / r.median : 0.0) << ", \"value\": " << r.value << "}";
+}
+
+static bool write_report(const string& path, const BenchOptions& o, const vector<BenchResult>& res) {
+    ofstream os(path);
+    if (!os) return false;
+    os << setprecision(9);
+    os << "{\n  \"tool\": \"misp-bench\",\n  \"version\": 1,\n  \"label\": \"" << o.label
+       << "\",\n  \"seed\": " << o.seed << ",\n  \"reps\": " << o.reps << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < res.size(); ++i) {
+        write_result_json(os, res[i]);
+        os << (i + 1 < res.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+    return (bool)os;
+}
+
+// Lector mínimo para los reportes que escribe write_report (un resultado por línea).
+static string json_field(const string& line, const string& key) {
+    size_t k = line.find("\"" + key + "\":");
+    if (k == string::npos) return "";
+    size_t i = k + key.size() + 3;
+    while (i < line.size() && line[i] == ' ') ++i;
+    if (i < line.size() && line[i] == '"') {
+        size_t j = line.find('"', i + 1);
+        return line.substr(i + 1, j - i - 1);
+    }
+    size_t j = line.find_first_of(",}", i);
+    return line.substr(i, j - i);
+}
+
+static bool read_report(const string& path, vector<BenchResult>& res) {
+    ifstream in(path);
+    if (!in) return false;
+    string line;
+    while (getline(in, line)) {
+        if (line.find("\"kernel\"") == string::npos) continue;
+        BenchResult r;
+        r.n = stoi(json_field(line, "n"));
+        r.p = stod(json_field(line, "p"));
+        r.kernel = json_field(line, "kernel");
+        r.reps = stoi(json_field(line, "reps"));
+        r.median = stod(json_field(line, "median"));
+        r.p10 = stod(json_field(line, "p10"));
+        r.p90 = stod(json_field(line, "p90"));
+        r.min = stod(json_field(line, "min"));
+        r.max = stod(json_field(line, "max"));
+        r.value = stoll(json_field(line, "value"));
+        res.push_back(r);
+    }
+    return true;
+}
+
+// speedup = mediana base / mediana nueva (> 1: el build nuevo es más rápido). Se resume
+// con la media geométrica por núcleo.
+static int run_compare(const BenchOptions& o) {
+    vector<BenchResult> A, B;
+    if (!read_report(o.compare[0], A) || !read_report(o.compare[1], B)) {
+        cerr << "No se pudo leer " << o.compare[0] << " o " << o.compare[1] << endl;
+        return 1;
+    }
+    map<tuple<int, long long, string>, const BenchResult*> base;
+    for (const auto& r : A) base[{r.n, llround(r.p * 1000), r.kernel}] = &r;
+
+    struct Row { const BenchResult *a, *b; double speedup; };
+    vector<Row> rows;
+    map<string, pair<double, int>> geo;   // kernel -> (suma de logs, cantidad)
+    for (const auto& r : B) {
+        auto it = base.find({r.n, llround(r.p * 1000), r.kernel});
+        if (it == base.end() || r.median <= 0) continue;
+        double sp = it->second->median / r.median;
+        rows.push_back({it->second, &r, sp});
+        auto& g = geo[r.kernel];
+        g.first += log(sp);
+        g.second++;
+    }
+
+    cout << "n,p,kernel,base_median,new_median,speedup,base_value,new_value" << endl;
+    for (const auto& x : rows)
+        cout << setprecision(6) << x.b->n << "," << x.b->p << "," << x.b->kernel << "," << x.a->median << ","
+             << x.b->median << "," << fixed << setprecision(3) << x.speedup << defaultfloat << ","
+             << x.a->value << "," << x.b->value << endl;
+    cout << "# media geometrica del speedup por nucleo" << endl;
+    for (const auto& [k, g] : geo)
+        cout << "# " << k << " " << fixed << setprecision(3) << exp(g.first / g.second) << defaultfloat << endl;
+
+    if (!o.out.empty()) {
+        ofstream os(o.out);
+        if (!os) { cerr << "No se pudo escribir " << o.out << endl; return 1; }
+        os << setprecision(9);
+        os << "{\n  \"tool\": \"misp-bench-compare\",\n  \"base\": \"" << o.compare[0]
+           << "\",\n  \"new\": \"" << o.compare[1] << "\",\n  \"results\": [\n";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const auto& x = rows[i];
+            os << "    {\"n\": " << x.b->n << ", \"p\": " << x.b->p << ", \"kernel\": \"" << x.b->kernel
+               << "\", \"base_median\": " << x.a->median << ", \"new_median\": " << x.b->median
+               << ", \"speedup\": " << x.speedup << ", \"base_value\": " << x.a->value
+               << ", \"new_value\": " << x.b->value << "}" << (i + 1 < rows.size() ? ",\n" : "\n");
+        }
+        os << "  ],\n  \"geomean_speedup\": {";
+        size_t i = 0;
+        for (const auto& [k, g] : geo)
+            os << (i++ ? ", " : "") << "\"" << k << "\": " << exp(g.first / g.second);
+        os << "}\n}\n";
+    }
+    return 0;
+}
+
+// -------------------- main --------------------
+template <class T>
+static vector<T> parse_list(const string& s) {
+    vector<T> v;
+    stringstream ss(s);
+    string tok;
+    while (getline(ss, tok, ',')) {
+        if (tok.empty()) continue;
+        if constexpr (is_same_v<T, int>) v.push_back(stoi(tok));
+        else v.push_back(stod(tok));
+    }
+    return v;
+}
+
+static void print_usage() {
+    cerr << "Uso: ./bench [--sizes 1000,2000,3000] [--dens 0.1,...,0.9] [--seed S] [--reps R]\n"
+            "              [--blocks B] [--ils-time T] [--backend auto|csr|bits|comp]\n"
+            "              [--tmp dir] [--label texto] [-o reporte.json]\n"
+            "     ./bench --compare base.json nuevo.json [-o comparacion.json]\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions o;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        auto need = [&] { return i + 1 < argc; };
+        if (a == "--sizes" && need())         o.sizes = parse_list<int>(argv[++i]);
+        else if (a == "--dens" && need())     o.dens = parse_list<double>(argv[++i]);
+        else if (a == "--seed" && need())     o.seed = stoull(argv[++i]);
+        else if (a == "--reps" && need())     o.reps = max(1, stoi(argv[++i]));
+        else if (a == "--blocks" && need())   o.blocks = max(1, stoi(argv[++i]));
+        else if (a == "--ils-time" && need()) o.ils_time = stod(argv[++i]);
+        else if (a == "--tmp" && need())      o.tmp = argv[++i];
+        else if (a == "--label" && need())    o.label = argv[++i];
+        else if (a == "-o" && need())         o.out = argv[++i];
+        else if (a == "--backend" && need()) {
+            if (!parse_backend(argv[++i], o.backend)) { print_usage(); return 1; }
+        }
+        else if (a == "--compare" && i + 2 < argc) { o.compare = {argv[i + 1], argv[i + 2]}; i += 2; }
+        else { print_usage(); return 1; }
+    }
+    if (!o.compare.empty()) return run_compare(o);
+
+    namespace fs = std::filesystem;
+    const fs::path dir = o.tmp.empty() ? fs::temp_directory_path() : fs::path(o.tmp);
+    vector<BenchResult> results;
+    cout << "n,p,kernel,median,p10,p90,per_sec,value" << endl;
+    for (int n : o.sizes) {
+        for (double p : o.dens) {
+            ostringstream name;
+            name << "bench_" << n << "_" << p << "_" << o.seed << ".graph";
+            const string path = (dir / name.str()).string();
+            if (!write_er_graph(path, n, p, o.seed)) {
+                cerr << "No se pudo escribir " << path << endl;
+                return 1;
+            }
+
+            const size_t first = results.size();
+            vector<double> loads;
+            long long m = 0;
+            for (int r = 0; r < o.reps; ++r) {
+                auto start = steady_clock::now();
+                bool ok = with_loaded_graph(path, [&](const auto& G) {
+                    loads.push_back(duration<double>(steady_clock::now() - start).count());
+                    m = G.m;
+                    if (r + 1 == o.reps) bench_kernels(G, p, o, results);
+                }, o.backend);
+                if (!ok) {
+                    cerr << "No se pudo abrir archivo " << path << endl;
+                    return 1;
+                }
+            }
+            results.insert(results.begin() + first, summarize(n, p, "load", loads, m));
+            fs::remove(path);
+
+            for (size_t i = first; i < results.size(); ++i) {
+                const auto& r = results[i];
+                cout << r.n << "," << r.p << "," << r.kernel << "," << r.median << "," << r.p10 << ","
+                     << r.p90 << "," << (r.median > 0 ? 1.0 / r.median : 0.0) << "," << r.value << endl;
+            }
+        }
+    }
+
+    if (!o.out.empty() && !write_report(o.out, o, results)) {
+        cerr << "No se pudo escribir " << o.out << endl;
+        return 1;
+    }
+    return 0;
+}
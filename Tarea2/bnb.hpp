@@ -0,0 +1,178 @@
+// bnb.hpp
+// Branch-and-bound exacto para MISP: clique máxima en el complemento al estilo BBMC
+// (San Segundo et al.), con conjuntos de vértices como bitsets.
+//
+//   - Los vértices se renumeran por grado no creciente en el complemento; bit i = i-ésimo.
+//   - En cada nodo, P (candidatos) se colorea greedy: cada color es un conjunto
+//     independiente del complemento armado con ANDs por palabra. Un vértice de color c
+//     no puede extender la clique actual más allá de |cur| + c.
+//   - Solo se ramifica sobre los vértices con color >= best - |cur| + 1; se recorren en
+//     orden inverso de coloreo y se poda en cuanto |cur| + c <= best.
+//
+// Cota superior ante timeout: las ramas de la raíz se recorren con color no creciente;
+// toda solución aún no vista está en la rama actual o en una posterior, así que
+// max(best, color de la rama actual de la raíz) es una cota válida.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "graph.hpp"
+#include "ils.hpp"
+
+template <class Graph>
+struct BnBSolver {
+    const Graph& G;
+    int n = 0, W = 0;
+    std::vector<int> order;          // bit i -> vértice original
+    std::vector<uint64_t> adj;       // fila i (complemento) en adj[i*W .. (i+1)*W)
+
+    int best = 0;
+    std::vector<int> best_set;       // ids originales
+    double best_time = 0.0;
+    long long nodes = 0;
+    bool timed_out = false;
+    int root_bound = 0;              // cota de la rama actual de la raíz
+
+    BnBSolver(const Graph& g) : G(g) {}
+
+    // Arma el complemento en bits con los vértices ordenados por grado no creciente en el
+    // complemento (= grado creciente en G; empate por id).
+    void build() {
+        n = G.n;
+        W = (n + 63) / 64;
+        if ((int)G.degree_order.size() == n) {
+            order = G.degree_order;   // caché binaria o grafo reetiquetado
+        } else {
+            order.resize(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](int x, int y) { return G.degree(x) < G.degree(y); });
+        }
+        std::vector<int> pos(n);
+        for (int i = 0; i < n; ++i) pos[order[i]] = i;
+
+        adj.assign((size_t)n * W, 0);
+        for (int i = 0; i < n; ++i) {
+            uint64_t* r = row(i);
+            for (int w = 0; w < W; ++w) r[w] = ~0ULL;
+            if (n & 63) r[W - 1] = (1ULL << (n & 63)) - 1;
+            r[i >> 6] &= ~(1ULL << (i & 63));
+            for (int v : G.neighbors(order[i])) { int j = pos[v]; r[j >> 6] &= ~(1ULL << (j & 63)); }
+        }
+    }
+
+    // Busca hasta t_end (tiempo de tim). lb/lb_set: incumbente inicial (p.ej. de ILS).
+    // inc recibe cada mejora. Devuelve la cota superior probada (== best si terminó).
+    int run(Timer& tim, double t_end, int lb, const std::vector<int>& lb_set, Incumbent& inc) {
+        timer = &tim; deadline = t_end; incumbent = &inc;
+        best = lb; best_set = lb_set; nodes = 0; timed_out = false; work = 0;
+        if (n == 0) return best;
+
+        cur.clear();
+        vbuf.assign(n + 1, {});
+        cbuf.assign(n + 1, {});
+        U.assign(W, 0); Q.assign(W, 0);
+        P.assign((size_t)(n + 1) * W, 0);     // un P por profundidad
+        for (int i = 0; i < n; ++i) P[i >> 6] |= 1ULL << (i & 63);
+        root_bound = n;
+        expand(0);
+        return timed_out ? std::max(best, root_bound) : best;
+    }
+
+private:
+    Timer* timer = nullptr;
+    double deadline = 0.0;
+    Incumbent* incumbent = nullptr;
+    std::vector<uint64_t> P;
+    std::vector<int> cur;
+    std::vector<std::vector<int>> vbuf, cbuf;   // vértices/colores a ramificar por profundidad
+    std::vector<uint64_t> U, Q;                  // scratch del coloreo
+
+    // El reloj se consulta por trabajo hecho (palabras recorridas) y no por nodos: con n
+    // grande un solo coloreo cerca de la raíz cuesta O(|P|·n/64) y 1024 nodos pasarían
+    // del límite por segundos.
+    static constexpr long long kPollWork = 1 << 16;
+    long long work = 0;                          // palabras desde la última consulta
+
+    bool out_of_time() {
+        if (work < kPollWork) return timed_out;
+        work = 0;
+        if (timer->elapsed() >= deadline) timed_out = true;
+        return timed_out;
+    }
+
+    uint64_t* row(int i) { return adj.data() + (size_t)i * W; }
+
+    void improve() {
+        best = (int)cur.size();
+        best_set.clear();
+        for (int i : cur) best_set.push_back(order[i]);
+        std::sort(best_set.begin(), best_set.end());
+        best_time = timer->elapsed();
+        struct View {
+            const std::vector<int>& S;
+            int size() const { return (int)S.size(); }
+            void copy_to(std::vector<int>& out) const { out = S; }
+        } view{best_set};
+        incumbent->offer(view, best_time);
+    }
+
+    void expand(int depth) {
+        ++nodes;
+        work += W;
+        if (out_of_time()) return;
+
+        uint64_t* Pd = P.data() + (size_t)depth * W;
+        uint64_t* Pn = Pd + W;
+
+        // Coloreo greedy sobre P; solo se guardan los vértices con color >= kmin.
+        const int kmin = std::max(1, best - depth + 1);
+        auto& verts = vbuf[depth];
+        auto& colors = cbuf[depth];
+        verts.clear(); colors.clear();
+        std::copy(Pd, Pd + W, U.begin());
+        int k = 0;
+        for (int w0 = 0; w0 < W; ) {
+            if (!U[w0]) { ++w0; continue; }
+            ++k;
+            work += W;
+            std::copy(U.begin(), U.end(), Q.begin());
+            for (int w = w0; w < W; ++w) {
+                while (Q[w]) {
+                    int v = w * 64 + std::countr_zero(Q[w]);
+                    Q[w] &= Q[w] - 1;
+                    U[w] &= ~(1ULL << (v & 63));
+                    const uint64_t* r = row(v);
+                    for (int x = w; x < W; ++x) Q[x] &= ~r[x];
+                    work += W - w;
+                    if (k >= kmin) { verts.push_back(v); colors.push_back(k); }
+                }
+            }
+        }
+        if (depth == 0) root_bound = k;
+
+        for (int i = (int)verts.size() - 1; i >= 0; --i) {
+            const int c = colors[i];
+            if (depth + c <= best) return;
+            if (depth == 0) root_bound = c;
+            const int v = verts[i];
+            const uint64_t* r = row(v);
+            bool any = false;
+            for (int w = 0; w < W; ++w) { Pn[w] = Pd[w] & r[w]; any |= Pn[w] != 0; }
+            work += W;
+            cur.push_back(v);
+            if (!any) {
+                if (depth + 1 > best) improve();
+            } else {
+                expand(depth + 1);
+            }
+            cur.pop_back();
+            if (timed_out) return;
+            Pd[v >> 6] &= ~(1ULL << (v & 63));
+        }
+    }
+};
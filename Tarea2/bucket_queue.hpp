@@ -0,0 +1,220 @@
+// bucket_queue.hpp
+// Cola por grados para los greedy de solver y solverRandom (DegreeBuckets) y candidatos
+// por clave fija para la construcción del ILS (CandidateBuckets, al final).
+//
+// Los vértices vivos se guardan en un arreglo ordenado por clave (grado residual), con
+// un bloque contiguo por clave (bin sort de Batagelj–Zaversnik). Los removidos quedan
+// en un prefijo del arreglo:
+//
+//   vert = [ removidos | clave 0 | clave 1 | ... | clave max ]
+//
+//   - decrement(v): O(1), intercambia v con el primero de su bloque y corre el borde.
+//   - remove(v):    O(clave(v)), baja v bloque a bloque hasta el prefijo de removidos.
+//                   La suma sobre todo el greedy es O(m) (la clave nunca supera el grado).
+//   - at(r):        O(1), vértice de rango r en el orden actual por clave.
+//   - min_vertex(): O(1) amortizado, menor id de la menor clave (con init(..., true)).
+// Sin heap: no hay entradas viejas que filtrar ni re-inserciones.
+//
+// Dentro de un bloque el orden por id se pierde con los intercambios, así que el desempate
+// por id usa un índice aparte: por clave, una jerarquía de bitsets de 64 ramas sobre los
+// grupos de 64 ids (el último nivel, un bit por id, no se guarda: es key[v] == k). Entrar a
+// una clave prende a lo sumo un bit por nivel; salir no toca nada y el bit que sobra se
+// apaga cuando min_vertex baja por él y no encuentra a nadie. Cada bit se prende y se apaga
+// una vez por entrada, así que el greedy completo sigue en O(n + m). Memoria: ~(clave máx.
+// + 1) * n / 4096 palabras.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+struct DegreeBuckets {
+    std::vector<int> vert;  // vértices ordenados por clave
+    std::vector<int> pos;   // pos[v] = índice de v en vert
+    std::vector<int> key;   // clave actual (-1 = removido)
+    std::vector<int> start; // start[k] = inicio del bloque de clave k; start[maxk+1] = n
+    int n = 0;
+    int removed_count = 0;
+    bool by_id = false;     // mantiene el índice de min_vertex
+
+    DegreeBuckets() = default;
+
+    // Orden inicial: clave ascendente y, a igual clave, id ascendente. index_by_id arma el
+    // índice de min_vertex (los que solo usan at() no lo necesitan).
+    template <class KeyFn>
+    void init(int N, KeyFn&& key_of, bool index_by_id = false) {
+        n = N; removed_count = 0;
+        key.resize(n);
+        int maxk = 0;
+        for (int v = 0; v < n; ++v) { key[v] = key_of(v); maxk = std::max(maxk, key[v]); }
+        start.assign(maxk + 2, 0);
+        for (int v = 0; v < n; ++v) start[key[v] + 1]++;
+        for (int k = 1; k <= maxk + 1; ++k) start[k] += start[k - 1];
+        vert.resize(n); pos.resize(n);
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int v = 0; v < n; ++v) { pos[v] = fill[key[v]]++; vert[pos[v]] = v; }
+
+        by_id = index_by_id;
+        lvl.clear(); words.clear();
+        if (!by_id || n == 0) return;
+        for (int bits = (n + 63) / 64;;) {   // bits = grupos (nivel 0) o palabras del nivel anterior
+            const int w = (bits + 63) / 64;
+            words.push_back(w);
+            lvl.emplace_back((size_t)(maxk + 1) * w, 0);
+            if (w == 1) break;
+            bits = w;
+        }
+        for (int v = 0; v < n; ++v) mark(v, key[v]);
+    }
+
+    bool empty() const { return removed_count == n; }
+    int size() const { return n - removed_count; }
+    bool removed(int v) const { return key[v] < 0; }
+
+    // Vértice de rango r (0 = menor clave) entre los vivos.
+    int at(int r) const { return vert[removed_count + r]; }
+    int min_key() const { return key[vert[removed_count]]; }
+
+    // Vivo de menor clave y, a igual clave, menor id. Requiere init(..., true).
+    int min_vertex() {
+        return first_in(min_key(), (int)lvl.size() - 1, 0);
+    }
+
+    void decrement(int v) {
+        lower(v);
+        if (by_id) mark(v, key[v]);
+    }
+
+    void remove(int v) {
+        while (key[v] > 0) lower(v);
+        swap_at(pos[v], start[0]);
+        start[0]++;
+        removed_count++;
+        key[v] = -1;
+    }
+
+private:
+    std::vector<std::vector<uint64_t>> lvl;   // lvl[l][k * words[l] + i]; l = 0 sobre grupos de 64 ids
+    std::vector<int> words;                   // palabras por clave en cada nivel
+
+    void lower(int v) {
+        int k = key[v];
+        int f = start[k];
+        swap_at(pos[v], f);
+        start[k]++;
+        key[v] = k - 1;
+    }
+
+    // Prende el camino de v en el índice de la clave k; para en la primera palabra que ya
+    // tenía algo (sus ancestros ya están prendidos).
+    void mark(int v, int k) {
+        for (size_t l = 0, i = (size_t)v >> 6; l < lvl.size(); ++l, i >>= 6) {
+            uint64_t& w = lvl[l][(size_t)k * words[l] + (i >> 6)];
+            const bool had = w != 0;
+            w |= 1ULL << (i & 63);
+            if (had) break;
+        }
+    }
+
+    // Menor id con clave k bajo la palabra i del nivel l, o -1. Las ramas que ya no tienen
+    // vértices de clave k se apagan al pasar.
+    int first_in(int k, int l, size_t i) {
+        uint64_t& w = lvl[l][(size_t)k * words[l] + i];
+        while (w) {
+            const size_t j = i * 64 + (size_t)std::countr_zero(w);
+            if (l == 0) {
+                const int b = (int)(j * 64), e = std::min(n, b + 64);
+                for (int v = b; v < e; ++v) if (key[v] == k) return v;
+            } else {
+                const int v = first_in(k, l - 1, j);
+                if (v >= 0) return v;
+            }
+            w &= w - 1;
+        }
+        return -1;
+    }
+
+    void swap_at(int i, int j) {
+        int a = vert[i], b = vert[j];
+        vert[i] = b; pos[b] = i;
+        vert[j] = a; pos[a] = j;
+    }
+};
+
+// Candidatos por clave fija (el grado estático) para la construcción aleatorizada del ILS.
+// Como en DegreeBuckets, un bloque contiguo por clave en vert; pero la clave no cambia,
+// así que dentro de cada bloque los vivos ocupan un prefijo y remove(v) es O(1)
+// (intercambio con el último vivo del bloque). Los vivos por clave van en un árbol de
+// Fenwick, y at(r) busca el bloque del rango r en O(log claves).
+//
+//   vert = [ clave 0: vivos | muertos ][ clave 1: vivos | muertos ] ...
+struct CandidateBuckets {
+    std::vector<int> vert;  // vértices ordenados por clave
+    std::vector<int> pos;   // pos[v] = índice de v en vert
+    std::vector<int> key;   // clave (-1 = removido)
+    std::vector<int> start; // start[k] = inicio del bloque de clave k
+    std::vector<int> live;  // vivos en el bloque k
+    std::vector<int> fen;   // Fenwick (1-indexado) sobre live
+    int n = 0;
+    int alive = 0;
+    int top = 1;            // mayor potencia de 2 <= cantidad de claves
+
+    // Orden inicial: clave ascendente y, a igual clave, id ascendente. Las claves se
+    // guardan desde la mínima (en grafos densos los grados van de ~0.9n a n).
+    template <class KeyFn>
+    void init(int N, KeyFn&& key_of) {
+        n = alive = N;
+        key.resize(n);
+        int mink = N > 0 ? key_of(0) : 0, maxk = mink;
+        for (int v = 0; v < n; ++v) {
+            key[v] = key_of(v);
+            mink = std::min(mink, key[v]);
+            maxk = std::max(maxk, key[v]);
+        }
+        for (int v = 0; v < n; ++v) key[v] -= mink;
+        const int K = maxk - mink + 1;
+        start.assign(K + 1, 0);
+        for (int v = 0; v < n; ++v) start[key[v] + 1]++;
+        live.assign(start.begin() + 1, start.end());
+        for (int k = 1; k <= K; ++k) start[k] += start[k - 1];
+        vert.resize(n); pos.resize(n);
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int v = 0; v < n; ++v) { pos[v] = fill[key[v]]++; vert[pos[v]] = v; }
+        // Fenwick en O(K).
+        fen.assign(K + 1, 0);
+        for (int i = 1; i <= K; ++i) {
+            fen[i] += live[i - 1];
+            int j = i + (i & -i);
+            if (j <= K) fen[j] += fen[i];
+        }
+        top = 1;
+        while (top * 2 <= K) top *= 2;
+    }
+
+    bool empty() const { return alive == 0; }
+    int size() const { return alive; }
+    bool removed(int v) const { return key[v] < 0; }
+
+    // Vivo de rango r (0 = menor clave); dentro de una clave el orden es arbitrario.
+    int at(int r) const {
+        int k = 0;   // cantidad de bloques completos antes del buscado
+        for (int step = top; step > 0; step >>= 1) {
+            int j = k + step;
+            if (j < (int)fen.size() && fen[j] <= r) { k = j; r -= fen[j]; }
+        }
+        return vert[start[k] + r];
+    }
+
+    void remove(int v) {
+        const int k = key[v];
+        const int last = start[k] + --live[k];
+        const int u = vert[last];
+        vert[pos[v]] = u; pos[u] = pos[v];
+        vert[last] = v; pos[v] = last;
+        for (int i = k + 1; i < (int)fen.size(); i += i & -i) fen[i]--;
+        key[v] = -1;
+        --alive;
+    }
+};
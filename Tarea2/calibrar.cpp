@@ -0,0 +1,443 @@
+// calibrar.cpp
+// Calibración de alpha / perturb / ls del ILS por carreras iteradas (estilo irace / F-race).
+//
+// Reemplaza los barridos de run_calibracion_uno.sh (un proceso por configuración e
+// instancia, con todas las configuraciones corriendo todas las instancias):
+//   - Se toma una muestra de instancias estratificada por densidad y cada grafo se carga
+//     una sola vez en memoria; todas las configuraciones lo comparten.
+//   - La carrera avanza de a una instancia: las configuraciones vivas corren en paralelo
+//     (una corrida de un walker por núcleo) con la misma semilla por instancia (números
+//     aleatorios comunes), y el valor es el FINAL_BEST.
+//   - Desde la instancia --first, tras cada instancia se aplica el test de Friedman sobre
+//     los rangos por instancia; si rechaza, se descartan las configuraciones cuya suma de
+//     rangos es significativamente peor que la mejor (post-hoc de Conover, stats.hpp),
+//     dejando al menos --elites.
+//   - Con rangos (lo:hi) hay varias iteraciones: las siguientes muestrean configuraciones
+//     nuevas alrededor de las élites con una dispersión que se achica. Las élites no se
+//     vuelven a correr: sus resultados por instancia se reutilizan.
+//
+// Compilar (Linux):
+//   g++ -O3 -march=native -std=c++20 -Wall -Wextra -pthread -o calibrar calibrar.cpp
+//
+// Ejecutar:
+//   ./calibrar -d new_1000_dataset -t 1 --sample 20
+//   ./calibrar -d new_1000_dataset --alpha 0.05:0.9 --perturb 2:8 --ls 500:8000
+//       --max-iters 20000 --iterations 4 --configs 24 -o ranking.csv   (en una sola línea)
+//
+// Salida: "MEJOR alpha=.. perturb=.. ls=.." por stdout y un CSV con el ranking por densidad
+//   densidad,rank,alpha,perturb,ls,mean_best,mean_rank,count   (densidad "todas" = global)
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "dataset.hpp"
+#include "graph.hpp"
+#include "ils.hpp"
+#include "reduce.hpp"
+#include "stats.hpp"
+
+using namespace std;
+
+// -------------------- Parámetros a calibrar --------------------
+// Lista de valores ("0.1,0.3,0.5") o rango continuo ("0.05:0.9"; en enteros, redondeado).
+struct ParamSpace {
+    bool integer = false;
+    bool range = false;
+    double lo = 0.0, hi = 0.0;
+    vector<double> values;
+
+    bool parse(const string& s) {
+        values.clear();
+        size_t colon = s.find(':');
+        try {
+            if (colon != string::npos) {
+                range = true;
+                lo = stod(s.substr(0, colon));
+                hi = stod(s.substr(colon + 1));
+                if (hi < lo) swap(lo, hi);
+                return true;
+            }
+            range = false;
+            stringstream ss(s);
+            string x;
+            while (getline(ss, x, ',')) if (!x.empty()) values.push_back(stod(x));
+        } catch (...) {
+            return false;
+        }
+        return !values.empty();
+    }
+
+    double fix(double v) const {
+        if (range) v = min(hi, max(lo, v));
+        return integer ? round(v) : v;
+    }
+
+    double uniform(mt19937_64& rng) const {
+        if (!range) return values[uniform_int_distribution<size_t>(0, values.size() - 1)(rng)];
+        return fix(uniform_real_distribution<double>(lo, hi)(rng));
+    }
+
+    // Valor cerca de v: normal con desvío frac * (hi - lo) en rangos; en listas, se
+    // conserva v con probabilidad 1 - frac.
+    double around(double v, double frac, mt19937_64& rng) const {
+        if (!range) return bernoulli_distribution(frac)(rng) ? uniform(rng) : v;
+        return fix(normal_distribution<double>(v, frac * (hi - lo))(rng));
+    }
+};
+
+struct Config {
+    double alpha = 0.3;
+    int perturb = 3;
+    int ls = 2000;
+    vector<int> best;        // FINAL_BEST por instancia de la muestra (-1 = no corrida)
+
+    bool same(const Config& o) const {
+        return fabs(alpha - o.alpha) < 1e-9 && perturb == o.perturb && ls == o.ls;
+    }
+};
+
+// -------------------- CLI Options --------------------
+struct CalibOptions {
+    bool ok = false;
+    string error;
+
+    string dir;
+    string out_csv = "ranking_calibracion.csv";
+    int sample = 20;            // instancias de la muestra (0 = todas)
+    uint64_t seed = 123456789ULL;
+    int jobs = 0;               // corridas en paralelo (0 = hardware_concurrency)
+    GraphBackend backend = GraphBackend::Auto;
+    VertexOrder relabel = VertexOrder::None;
+
+    ParamSpace alpha, perturb, ls;   // perturb y ls enteros
+    ILSParams ils;              // tiempo, --adaptive, --max-iters, --stagnation
+
+    int first = 5;              // instancias antes del primer test
+    double confidence = 0.95;
+    int elites = 3;             // sobrevivientes mínimos / élites entre iteraciones
+    int iterations = 0;         // 0 = 1 con solo listas, 3 con algún rango
+    int configs = 0;            // configuraciones nuevas por iteración (0 = automático)
+};
+
+static void print_usage() {
+    cerr <<
+      "Uso:\n"
+      "  calibrar -d <carpeta> [-t T] [--sample K] [--seed S] [-j hilos] [-o ranking.csv]\n"
+      "           [--alpha L] [--perturb L] [--ls L]      (L = a,b,c  o  lo:hi)\n"
+      "           [--adaptive] [--rcl static|residual] [--max-iters I] [--stagnation N] [--backend auto|csr|bits|comp]\n"
+      "           [--relabel none|degree|rcm|cluster]\n"
+      "           [--first F] [--confidence C] [--elites E] [--iterations N] [--configs N]\n"
+      "\n"
+      "  Por defecto: --alpha 0.1,0.3,0.5,0.7 --perturb 2,3,4,5 --ls 1000,2000,4000 (grilla de 48),\n"
+      "  -t 1, --sample 20 (estratificada por densidad), --first 5, --confidence 0.95, --elites 3.\n"
+      "  Con --max-iters (y sin depender de -t) la calibración es reproducible.\n";
+}
+
+CalibOptions parse_args(int argc, char** argv) {
+    CalibOptions o;
+    o.ils.time_limit = 1.0;
+    o.perturb.integer = o.ls.integer = true;
+    o.alpha.parse("0.1,0.3,0.5,0.7");
+    o.perturb.parse("2,3,4,5");
+    o.ls.parse("1000,2000,4000");
+
+    auto need = [&](int i){ return i+1 < argc; };
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "-d" && need(i))                 o.dir = argv[++i];
+        else if (a == "-o" && need(i))            o.out_csv = argv[++i];
+        else if (a == "-t" && need(i))            o.ils.time_limit = stod(argv[++i]);
+        else if (a == "-j" && need(i))            o.jobs = stoi(argv[++i]);
+        else if (a == "--sample" && need(i))      o.sample = stoi(argv[++i]);
+        else if (a == "--seed" && need(i))        o.seed = stoull(argv[++i]);
+        else if (a == "--alpha" && need(i))       { if (!o.alpha.parse(argv[++i])) { o.error = "--alpha inválido"; return o; } }
+        else if (a == "--perturb" && need(i))     { if (!o.perturb.parse(argv[++i])) { o.error = "--perturb inválido"; return o; } }
+        else if (a == "--ls" && need(i))          { if (!o.ls.parse(argv[++i])) { o.error = "--ls inválido"; return o; } }
+        else if (a == "--adaptive")               o.ils.adaptive = true;
+        else if (a == "--rcl" && need(i)) {
+            string r = argv[++i];
+            if (r != "static" && r != "residual") { o.error = "--rcl debe ser static o residual"; return o; }
+            o.ils.rcl_residual = r == "residual";
+        }
+        else if (a == "--max-iters" && need(i))   o.ils.max_iters = stoll(argv[++i]);
+        else if (a == "--stagnation" && need(i))  o.ils.stagnation = stoll(argv[++i]);
+        else if (a == "--first" && need(i))       o.first = stoi(argv[++i]);
+        else if (a == "--confidence" && need(i))  o.confidence = stod(argv[++i]);
+        else if (a == "--elites" && need(i))      o.elites = stoi(argv[++i]);
+        else if (a == "--iterations" && need(i))  o.iterations = stoi(argv[++i]);
+        else if (a == "--configs" && need(i))     o.configs = stoi(argv[++i]);
+        else if (a == "--relabel" && need(i)) {
+            if (!parse_vertex_order(argv[++i], o.relabel)) { o.error = "--relabel debe ser none, degree, rcm o cluster"; return o; }
+        }
+        else if (a == "--backend" && need(i)) {
+            if (!parse_backend(argv[++i], o.backend)) { o.error = "--backend debe ser auto, csr, bits o comp"; return o; }
+        }
+        else { o.error = "Argumento desconocido: " + a; return o; }
+    }
+
+    if (o.dir.empty()) { o.error = "Falta -d <carpeta>"; return o; }
+    if (o.ils.time_limit <= 0) { o.error = "Tiempo -t debe ser > 0"; return o; }
+    if (o.confidence <= 0.0 || o.confidence >= 1.0) { o.error = "--confidence debe estar en (0, 1)"; return o; }
+    o.first = max(2, o.first);
+    o.elites = max(1, o.elites);
+    const bool ranged = o.alpha.range || o.perturb.range || o.ls.range;
+    if (o.iterations <= 0) o.iterations = ranged ? 3 : 1;
+    if (o.jobs <= 0) o.jobs = max(1, (int)thread::hardware_concurrency());
+    o.ils.threads = 1;   // el paralelismo es entre configuraciones
+    o.ok = true;
+    return o;
+}
+
+// -------------------- Muestra de instancias --------------------
+// K instancias repartidas entre densidades (ronda sobre las densidades, al azar dentro de
+// cada una) y ordenadas en esa misma ronda, así las primeras etapas de la carrera ya
+// cubren todas las densidades.
+static vector<Instance> stratified_sample(vector<Instance> L, int K, mt19937_64& rng) {
+    map<double, vector<Instance>> by_dens;
+    for (auto& in : L) by_dens[stod(in.densidad)].push_back(std::move(in));
+    for (auto& [d, v] : by_dens) shuffle(v.begin(), v.end(), rng);
+    vector<Instance> S;
+    const size_t total = L.size();
+    if (K <= 0 || (size_t)K > total) K = (int)total;
+    for (size_t r = 0; (int)S.size() < K; ++r)
+        for (auto& [d, v] : by_dens)
+            if (r < v.size() && (int)S.size() < K) S.push_back(v[r]);
+    return S;
+}
+
+// -------------------- Carrera --------------------
+struct Race {
+    const CalibOptions& o;
+    const vector<Instance>& S;
+    const vector<OwnedGraph>& graphs;
+    vector<Config>& C;
+    long long runs = 0;
+
+    // Corre las configuraciones ids sobre la instancia s (las que ya tienen resultado se saltean).
+    void run_stage(int s, const vector<int>& ids) {
+        vector<int> todo;
+        for (int c : ids) if (C[c].best[s] < 0) todo.push_back(c);
+        if (todo.empty()) return;
+        visit([&](const auto& G) {
+            if constexpr (!is_same_v<decay_t<decltype(G)>, monostate>) {
+                atomic<size_t> next{0};
+                auto work = [&] {
+                    for (size_t k; (k = next++) < todo.size();) {
+                        Config& cf = C[todo[k]];
+                        ILSParams p = o.ils;
+                        p.alpha = cf.alpha;
+                        p.perturb_k = cf.perturb;
+                        p.ls_iters = cf.ls;
+                        p.seed = o.seed + (uint64_t)s;   // misma semilla para todas en la instancia
+                        Timer timer;
+                        Incumbent inc;
+                        inc.print = false;
+                        run_ils_portfolio(G, p, timer, inc);
+                        cf.best[s] = inc.val.load();
+                    }
+                };
+                const int T = max(1, min(o.jobs, (int)todo.size()));
+                vector<thread> th;
+                for (int i = 1; i < T; ++i) th.emplace_back(work);
+                work();
+                for (auto& x : th) x.join();
+            }
+        }, graphs[s]);
+        runs += (long long)todo.size();
+    }
+
+    // Carrera de las configuraciones alive sobre toda la muestra; devuelve las sobrevivientes.
+    vector<int> run(vector<int> alive) {
+        const int K = (int)S.size();
+        for (int s = 0; s < K; ++s) {
+            run_stage(s, alive);
+            cerr << "  [" << s + 1 << "/" << K << "] densidad=" << S[s].densidad << " vivas=" << alive.size();
+            if (s + 1 >= o.first && (int)alive.size() > o.elites) {
+                vector<vector<double>> ranks;
+                for (int t = 0; t <= s; ++t) {
+                    vector<double> x;
+                    for (int c : alive) x.push_back(C[c].best[t]);
+                    ranks.push_back(average_ranks(x, true));
+                }
+                FriedmanTest F;
+                F.run(ranks, o.confidence);
+                cerr << " p=" << setprecision(3) << F.p_value << defaultfloat;
+                vector<int> order(alive.size());
+                iota(order.begin(), order.end(), 0);
+                stable_sort(order.begin(), order.end(), [&](int a, int b) { return F.R[a] < F.R[b]; });
+                vector<int> keep;
+                for (int j : order)
+                    if ((int)keep.size() < o.elites || !F.worse_than_best(j)) keep.push_back(alive[j]);
+                if (keep.size() < alive.size()) cerr << " descartadas=" << alive.size() - keep.size();
+                alive = keep;
+            }
+            cerr << "\n";
+        }
+        return alive;
+    }
+};
+
+// Rango medio de cada configuración de ids sobre las instancias idx (1 = mejor).
+static vector<double> mean_ranks(const vector<Config>& C, const vector<int>& ids, const vector<int>& idx) {
+    vector<double> r(ids.size(), 0.0);
+    for (int s : idx) {
+        vector<double> x;
+        for (int c : ids) x.push_back(C[c].best[s]);
+        vector<double> rk = average_ranks(x, true);
+        for (size_t j = 0; j < ids.size(); ++j) r[j] += rk[j];
+    }
+    for (double& v : r) v /= max<size_t>(1, idx.size());
+    return r;
+}
+
+static void add_config(vector<Config>& C, Config c, int K) {
+    for (const auto& x : C) if (x.same(c)) return;
+    c.best.assign(K, -1);
+    C.push_back(std::move(c));
+}
+
+// -------------------- main --------------------
+int main(int argc, char** argv) {
+    CalibOptions o = parse_args(argc, argv);
+    if (!o.ok) {
+        print_usage();
+        cerr << "Error: " << o.error << "\n";
+        return 1;
+    }
+
+    vector<Instance> L = list_instances(o.dir);
+    if (L.empty()) {
+        cerr << "No se encontraron instancias en " << o.dir << "\n";
+        return 1;
+    }
+    mt19937_64 rng(o.seed);
+    vector<Instance> S = stratified_sample(std::move(L), o.sample, rng);
+    const int K = (int)S.size();
+
+    // Carga única de la muestra, en paralelo entre instancias; cada grafo queda convertido a
+    // su backend y lo comparten (solo lectura) todas las corridas.
+    vector<OwnedGraph> graphs(K);
+    {
+        vector<char> ok(K, 0);
+        atomic<int> next{0};
+        auto work = [&] {
+            for (int i; (i = next++) < K;) {
+                Reduction R;   // sin reducir: el valor es el FINAL_BEST del grafo completo
+                ok[i] = load_reduced_graph(S[i].path, graphs[i], R, o.backend, 1, false, false, o.relabel);
+            }
+        };
+        const int T = max(1, min(o.jobs, K));
+        vector<thread> th;
+        for (int i = 1; i < T; ++i) th.emplace_back(work);
+        work();
+        for (auto& x : th) x.join();
+        for (int i = 0; i < K; ++i)
+            if (!ok[i]) { cerr << "No se pudo leer " << S[i].path << "\n"; return 1; }
+    }
+    cerr << "Muestra: " << K << " instancias cargadas\n";
+
+    // Primera iteración: la grilla completa si todo son listas; si no, muestras uniformes.
+    vector<Config> C;
+    const bool ranged = o.alpha.range || o.perturb.range || o.ls.range;
+    if (!ranged && o.configs <= 0) {
+        for (double a : o.alpha.values)
+            for (double p : o.perturb.values)
+                for (double l : o.ls.values)
+                    add_config(C, {a, (int)p, (int)l, {}}, K);
+    } else {
+        const int N = o.configs > 0 ? o.configs : 24;
+        for (int tries = 0; (int)C.size() < N && tries < 100 * N; ++tries)
+            add_config(C, {o.alpha.uniform(rng), (int)o.perturb.uniform(rng), (int)o.ls.uniform(rng), {}}, K);
+    }
+
+    vector<int> alive(C.size());
+    iota(alive.begin(), alive.end(), 0);
+    Race race{o, S, graphs, C};
+    Timer total;
+    for (int it = 0; it < o.iterations; ++it) {
+        if (it > 0) {
+            // Nuevas configuraciones alrededor de las élites (elegidas por rango medio).
+            const double frac = 0.5 * pow(0.6, it);
+            const int N = o.configs > 0 ? o.configs : max(8, (int)C.size() / (it + 1));
+            const size_t before = C.size();
+            for (int tries = 0; C.size() - before < (size_t)N && tries < 100 * N; ++tries) {
+                const Config& e = C[alive[tries % alive.size()]];
+                add_config(C, {o.alpha.around(e.alpha, frac, rng), (int)o.perturb.around(e.perturb, frac, rng),
+                               (int)o.ls.around(e.ls, frac, rng), {}}, K);
+            }
+            for (size_t c = before; c < C.size(); ++c) alive.push_back((int)c);
+        }
+        cerr << "Iteración " << it + 1 << "/" << o.iterations << ": " << alive.size() << " configuraciones\n";
+        alive = race.run(alive);
+
+        vector<int> all(K);
+        iota(all.begin(), all.end(), 0);
+        vector<double> mr = mean_ranks(C, alive, all);
+        vector<int> order(alive.size());
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](int a, int b) { return mr[a] < mr[b]; });
+        vector<int> elite;
+        for (int j : order) if ((int)elite.size() < o.elites) elite.push_back(alive[j]);
+        alive = elite;
+    }
+
+    // Ranking final de las configuraciones que completaron la muestra, por densidad y global.
+    vector<int> done;
+    for (int c = 0; c < (int)C.size(); ++c)
+        if (all_of(C[c].best.begin(), C[c].best.end(), [](int v) { return v >= 0; })) done.push_back(c);
+    map<double, pair<string, vector<int>>> groups;
+    for (int s = 0; s < K; ++s) {
+        auto& g = groups[stod(S[s].densidad)];
+        g.first = S[s].densidad;
+        g.second.push_back(s);
+    }
+    vector<pair<string, vector<int>>> blocks;
+    for (auto& [d, g] : groups) blocks.push_back(g);
+    vector<int> all(K);
+    iota(all.begin(), all.end(), 0);
+    blocks.push_back({"todas", all});
+
+    ofstream csv(o.out_csv);
+    csv << "densidad,rank,alpha,perturb,ls,mean_best,mean_rank,count\n";
+    int best_cfg = alive.empty() ? -1 : alive[0];
+    for (const auto& [name, idx] : blocks) {
+        vector<double> mr = mean_ranks(C, done, idx);
+        vector<int> order(done.size());
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](int a, int b) { return mr[a] < mr[b]; });
+        for (size_t r = 0; r < order.size(); ++r) {
+            const Config& cf = C[done[order[r]]];
+            RunningStats st;
+            for (int s : idx) st.add(cf.best[s]);
+            csv << name << "," << r + 1 << "," << cf.alpha << "," << cf.perturb << "," << cf.ls << ","
+                << fixed << setprecision(6) << st.mean << "," << mr[order[r]] << defaultfloat << ","
+                << st.n << "\n";
+        }
+        if (name == "todas" && !order.empty()) best_cfg = done[order[0]];
+    }
+
+    cout << "\nCorridas: " << race.runs << " de " << (long long)C.size() * K << " sin descarte  ("
+         << fixed << setprecision(1) << total.elapsed() << " s)\n" << defaultfloat;
+    if (best_cfg >= 0) {
+        const Config& b = C[best_cfg];
+        RunningStats st;
+        for (int v : b.best) st.add(v);
+        cout << "MEJOR alpha=" << b.alpha << " perturb=" << b.perturb << " ls=" << b.ls
+             << "  mean_best=" << fixed << setprecision(3) << st.mean << defaultfloat << "\n";
+    }
+    cout << "Archivo generado: " << o.out_csv << "\n";
+    return 0;
+}
@@ -0,0 +1,326 @@
+// checkpoint.hpp
+// Checkpoints de corridas ILS largas (--checkpoint / --resume de IterativeLocalSearch).
+//
+// Cada `every` segundos el hilo escritor abre una época; cada walker, al empezar su
+// siguiente iteración, serializa su estado (ILS_MIS::save: solución actual con el orden
+// interno de MISState, mejor solución, estado del mt19937_64, contadores, control
+// adaptativo y plazo) y sigue buscando. Cuando todos los walkers de la época entregaron,
+// el escritor arma el archivo con el incumbente y lo escribe fuera de los hilos de
+// búsqueda: archivo temporal + fsync + rename + fsync del directorio, así un corte a mitad
+// de escritura deja el checkpoint anterior entero y uno después del rename ya ve el nuevo.
+// Al terminar la corrida se escribe el estado final.
+//
+// Con --resume cada walker sigue desde su estado sin construir. Con --threads 1 y parada
+// por iteraciones (--max-iters / --stagnation) la corrida retomada hace las mismas
+// iteraciones y termina en la misma solución que una sin cortes (los tiempos, no). Con
+// varios walkers el intercambio por el incumbente depende del reloj, como sin checkpoint.
+//
+// Formato (little-endian): CheckpointHeader | payload (relleno a 8 bytes)
+//   payload = fingerprint, elapsed, incumbente (val, time, set), walkers (estado de cada uno)
+// checksum = FNV-1a por palabras de 64 bits del payload (el mismo de graph_cache.hpp).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "graph_cache.hpp"
+
+constexpr char kCheckpointMagic[8] = {'M', 'I', 'S', 'P', 'C', 'K', 'P', '\0'};
+constexpr uint32_t kCheckpointVersion = 1;
+constexpr double kCheckpointEvery = 60.0;   // segundos entre checkpoints por defecto
+
+// -------------------- Serialización binaria --------------------
+struct CkptWriter {
+    std::string buf;
+
+    template <class T>
+    void put(const T& x) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        buf.append(reinterpret_cast<const char*>(&x), sizeof x);
+    }
+    template <class T>
+    void put_vec(const std::vector<T>& v) {
+        put<uint64_t>(v.size());
+        buf.append(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+    void put_str(const std::string& s) {
+        put<uint64_t>(s.size());
+        buf += s;
+    }
+};
+
+// Lectura con límites: ante datos truncados ok pasa a false y devuelve ceros/vacíos.
+struct CkptReader {
+    const char* p;
+    const char* end;
+    bool ok = true;
+
+    explicit CkptReader(const std::string& s) : p(s.data()), end(s.data() + s.size()) {}
+
+    template <class T>
+    T get() {
+        T x{};
+        if (!ok || (size_t)(end - p) < sizeof x) { ok = false; return x; }
+        std::memcpy(&x, p, sizeof x);
+        p += sizeof x;
+        return x;
+    }
+    template <class T>
+    void get_vec(std::vector<T>& v) {
+        const uint64_t k = get<uint64_t>();
+        v.clear();
+        if (!ok || k > (uint64_t)(end - p) / sizeof(T)) { ok = false; return; }
+        v.resize(k);
+        std::memcpy(v.data(), p, k * sizeof(T));
+        p += k * sizeof(T);
+    }
+    std::string get_str() {
+        const uint64_t k = get<uint64_t>();
+        if (!ok || k > (uint64_t)(end - p)) { ok = false; return {}; }
+        std::string s(p, k);
+        p += k;
+        return s;
+    }
+};
+
+// -------------------- Archivo --------------------
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t walkers;
+    uint64_t payload_bytes;
+    uint64_t checksum;
+};
+
+struct CheckpointData {
+    std::string fingerprint;          // parámetros e instancia: un --resume con otros se rechaza
+    double elapsed = 0.0;             // tiempo de la corrida al checkpoint
+    int inc_val = -1;
+    double inc_time = 0.0;
+    std::vector<int> inc_set;
+    std::vector<std::string> walkers; // ILS_MIS::save de cada walker
+};
+
+inline bool write_checkpoint(const std::string& path, const CheckpointData& d) {
+    using namespace graph_cache_detail;
+    CkptWriter w;
+    w.put_str(d.fingerprint);
+    w.put(d.elapsed);
+    w.put(d.inc_val);
+    w.put(d.inc_time);
+    w.put_vec(d.inc_set);
+    w.put<uint64_t>(d.walkers.size());
+    for (const auto& s : d.walkers) w.put_str(s);
+    w.buf.resize(align8(w.buf.size()), '\0');
+
+    CheckpointHeader h{};
+    std::memcpy(h.magic, kCheckpointMagic, 8);
+    h.version = kCheckpointVersion;
+    h.walkers = (uint32_t)d.walkers.size();
+    h.payload_bytes = w.buf.size();
+    Fnv64 ck;
+    ck.words(w.buf.data(), w.buf.size());
+    h.checksum = ck.h;
+
+    const std::string tmp = path + ".tmp" + std::to_string((long long)::getpid());
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    auto write_all = [&](const char* p, size_t k) {
+        while (k > 0) {
+            const ssize_t r = ::write(fd, p, k);
+            if (r <= 0) return false;
+            p += r;
+            k -= (size_t)r;
+        }
+        return true;
+    };
+    const bool ok = write_all(reinterpret_cast<const char*>(&h), sizeof h) &&
+                    write_all(w.buf.data(), w.buf.size()) && ::fsync(fd) == 0;
+    if (::close(fd) != 0 || !ok) { std::remove(tmp.c_str()); return false; }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) { std::remove(tmp.c_str()); return false; }
+
+    // El rename vive en el directorio: sin este fsync un corte puede deshacerlo.
+    const size_t slash = path.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    const int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dfd < 0) return false;
+    const bool synced = ::fsync(dfd) == 0;
+    ::close(dfd);
+    return synced;
+}
+
+// Lee y valida (firma, versión, tamaño y checksum) el checkpoint de path.
+inline bool read_checkpoint(const std::string& path, CheckpointData& d, std::string& err) {
+    using namespace graph_cache_detail;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) { err = "no se pudo abrir " + path; return false; }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    const std::string file = ss.str();
+    CheckpointHeader h;
+    if (file.size() < sizeof h) { err = path + " está truncado"; return false; }
+    std::memcpy(&h, file.data(), sizeof h);
+    if (std::memcmp(h.magic, kCheckpointMagic, 8) != 0) { err = path + " no es un checkpoint"; return false; }
+    if (h.version != kCheckpointVersion) { err = path + ": versión de checkpoint distinta"; return false; }
+    if (h.payload_bytes != file.size() - sizeof h || h.payload_bytes % 8) { err = path + " está truncado"; return false; }
+    const std::string payload = file.substr(sizeof h);
+    Fnv64 ck;
+    ck.words(payload.data(), payload.size());
+    if (ck.h != h.checksum) { err = path + ": checksum inválido"; return false; }
+
+    CkptReader r(payload);
+    d.fingerprint = r.get_str();
+    d.elapsed = r.get<double>();
+    d.inc_val = r.get<int>();
+    d.inc_time = r.get<double>();
+    r.get_vec(d.inc_set);
+    const uint64_t T = r.get<uint64_t>();
+    d.walkers.clear();
+    for (uint64_t i = 0; r.ok && i < T; ++i) d.walkers.push_back(r.get_str());
+    if (!r.ok || T != h.walkers) { err = path + ": contenido inválido"; return false; }
+    return true;
+}
+
+// -------------------- Escritor asíncrono --------------------
+// Los walkers consultan epoch() en cada iteración (una lectura atómica) y, si cambió,
+// entregan su estado con submit(); al salir de run entregan el final con last = true.
+class Checkpointer {
+public:
+    Checkpointer(std::string path, std::string fingerprint, double every, int walkers)
+        : path_(std::move(path)), fingerprint_(std::move(fingerprint)),
+          every_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(every))),
+          slots_(walkers) {}
+    ~Checkpointer() { stop_thread(); }
+
+    uint64_t epoch() const { return epoch_.load(std::memory_order_relaxed); }
+
+    void start() { th_ = std::thread([this] { loop(); }); }
+
+    void submit(int w, uint64_t e, std::string state, double t, int inc_val, double inc_time,
+                std::vector<int> inc_set, bool last) {
+        std::lock_guard<std::mutex> lk(mu_);
+        Slot& s = slots_[w];
+        s.state = std::move(state);
+        s.epoch = e;
+        s.t = t;
+        s.last = last;
+        s.inc_val = inc_val;
+        s.inc_time = inc_time;
+        s.inc_set = std::move(inc_set);
+        s.filled = true;
+        if (collecting_ && complete()) {
+            pending_ = assemble();
+            ready_ = true;
+            collecting_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    // Tras terminar los walkers: para el escritor y escribe el estado final.
+    bool finish() {
+        stop_thread();
+        std::lock_guard<std::mutex> lk(mu_);
+        for (const Slot& s : slots_) if (!s.filled) return !failed_;
+        if (!write_checkpoint(path_, assemble())) failed_ = true;
+        else ++written_;
+        return !failed_;
+    }
+
+    int written() const { return written_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        std::string state;
+        uint64_t epoch = 0;
+        double t = 0.0;
+        bool last = false, filled = false;
+        int inc_val = -1;
+        double inc_time = 0.0;
+        std::vector<int> inc_set;
+    };
+
+    bool complete() const {
+        const uint64_t e = epoch_.load(std::memory_order_relaxed);
+        for (const Slot& s : slots_) if (!s.last && s.epoch != e) return false;
+        return true;
+    }
+
+    // El incumbente de mayor valor entre los entregados (con un walker, el de su entrega).
+    CheckpointData assemble() const {
+        CheckpointData d;
+        d.fingerprint = fingerprint_;
+        const Slot* best = &slots_[0];
+        for (const Slot& s : slots_) {
+            d.elapsed = std::max(d.elapsed, s.t);
+            if (s.inc_val > best->inc_val) best = &s;
+            d.walkers.push_back(s.state);
+        }
+        d.inc_val = best->inc_val;
+        d.inc_time = best->inc_time;
+        d.inc_set = best->inc_set;
+        return d;
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lk(mu_);
+        auto next = Clock::now() + every_;
+        while (!stopping_) {
+            if (ready_) {
+                CheckpointData d = std::move(pending_);
+                ready_ = false;
+                lk.unlock();
+                const bool ok = write_checkpoint(path_, d);
+                lk.lock();
+                if (ok) ++written_;
+                else failed_ = true;
+                next = Clock::now() + every_;
+                continue;
+            }
+            if (!collecting_ && Clock::now() >= next) {
+                collecting_ = true;
+                epoch_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (collecting_) cv_.wait(lk, [&] { return stopping_ || ready_; });
+            else cv_.wait_until(lk, next, [&] { return stopping_ || ready_; });
+        }
+    }
+
+    void stop_thread() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (th_.joinable()) th_.join();
+    }
+
+    std::string path_, fingerprint_;
+    Clock::duration every_;
+    std::vector<Slot> slots_;
+    std::atomic<uint64_t> epoch_{0};
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::thread th_;
+    bool collecting_ = false, ready_ = false, stopping_ = false, failed_ = false;
+    int written_ = 0;
+    CheckpointData pending_;
+};
@@ -0,0 +1,92 @@
+// dataset.hpp
+// Instancias de una carpeta de dataset y pool de hilos con robo de trabajo, compartidos
+// por el runner batch y la calibración (calibrar).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// -------------------- Instancias --------------------
+struct Instance {
+    std::string densidad;    // tal como aparece en el nombre ("0.1")
+    int idx = 0;
+    std::string path;
+    uintmax_t bytes = 0;
+    int target = -1;         // ILS: objetivo de parada (-1 = ninguno)
+};
+
+// Nombres aceptados (los mismos patrones que buscaban los scripts):
+//   ...p0c0.1_1.graph, ...p0c0.1_001.graph, ...p0c0.1_graph1.graph
+// y sus versiones comprimidas (.graph.gz, .graph.zst, .graph.zip o .zip; ver graph_io.hpp).
+inline std::vector<Instance> list_instances(const std::string& dir) {
+    static const std::regex re(R"(p0c([0-9]+(?:\.[0-9]+)?)_(?:graph)?0*([0-9]+)\.(?:graph(?:\.gz|\.zst|\.zip)?|zip)$)");
+    std::vector<Instance> L;
+    std::error_code ec;
+    for (const auto& e : std::filesystem::directory_iterator(dir, ec)) {
+        if (!e.is_regular_file(ec)) continue;
+        std::string name = e.path().filename().string();
+        std::smatch mt;
+        if (!std::regex_search(name, mt, re)) continue;
+        Instance in;
+        in.densidad = mt[1];
+        in.idx = std::stoi(mt[2]);
+        in.path = e.path().string();
+        in.bytes = e.file_size(ec);
+        L.push_back(in);
+    }
+    std::sort(L.begin(), L.end(), [](const Instance& a, const Instance& b) {
+        double da = std::stod(a.densidad), db = std::stod(b.densidad);
+        if (da != db) return da < db;
+        if (a.idx != b.idx) return a.idx < b.idx;
+        return a.path < b.path;
+    });
+    return L;
+}
+
+// -------------------- Pool con robo de trabajo --------------------
+// Una deque por hilo. Cada hilo saca del frente de la suya y, si está vacía, roba del
+// final de la de otro. Las tareas se reparten de mayor a menor archivo, en ronda, así las
+// instancias grandes arrancan primero y las chicas rellenan el final.
+struct WorkStealingPool {
+    struct Queue {
+        std::mutex mu;
+        std::deque<int> q;
+    };
+    std::vector<Queue> qs;
+
+    explicit WorkStealingPool(int T) : qs(T) {}
+
+    void push(int w, int task) { qs[w].q.push_back(task); }
+
+    bool pop(int w, int& task) {
+        {
+            std::lock_guard<std::mutex> lk(qs[w].mu);
+            if (!qs[w].q.empty()) { task = qs[w].q.front(); qs[w].q.pop_front(); return true; }
+        }
+        const int T = (int)qs.size();
+        for (int d = 1; d < T; ++d) {
+            auto& v = qs[(w + d) % T];
+            std::lock_guard<std::mutex> lk(v.mu);
+            if (!v.q.empty()) { task = v.q.back(); v.q.pop_back(); return true; }
+        }
+        return false;
+    }
+
+    template <class F>
+    void run(F&& f) {
+        std::vector<std::thread> th;
+        for (int w = 1; w < (int)qs.size(); ++w)
+            th.emplace_back([&, w] { int t; while (pop(w, t)) f(t); });
+        int t;
+        while (pop(0, t)) f(t);
+        for (auto& x : th) x.join();
+    }
+};
@@ -0,0 +1,364 @@
+// decompress.hpp
+// Instancias comprimidas (.gz, .zst, .zip) leídas en el mismo proceso, sin pasar por un pipe.
+//
+// El formato se reconoce por la firma (gzip 1f 8b, zstd 28 b5 2f fd, zip PK\3\4), no por la
+// extensión. libz.so.1 y libzstd.so.1 se cargan con dlopen la primera vez que hacen falta:
+// los programas se compilan con la misma línea de g++ de siempre (sin -lz ni headers de
+// zstd) y, si falta una biblioteca, solo fallan las instancias en ese formato.
+//
+// decompress_lines entrega el texto en bloques de ~chunk bytes cortados en fin de línea,
+// así cada bloque se parsea sin mirar a los vecinos. ChunkQueue es la cola acotada entre el
+// hilo que descomprime y los que parsean (graph_io.hpp): si los parsers van atrás, push
+// espera, y la memoria queda en ~(capacidad + parsers) bloques.
+// .zip: se toma la primera entrada *.graph (o la primera, si ninguna lo es), guardada sin
+// comprimir o con deflate; ZIP64 y entradas cifradas no se aceptan.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include <dlfcn.h>
+
+enum class Compression { None, Gzip, Zstd, Zip };
+
+inline Compression detect_compression(const char* p, size_t n) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    if (n >= 2 && u[0] == 0x1f && u[1] == 0x8b) return Compression::Gzip;
+    if (n >= 4 && u[0] == 0x28 && u[1] == 0xb5 && u[2] == 0x2f && u[3] == 0xfd) return Compression::Zstd;
+    if (n >= 4 && u[0] == 'P' && u[1] == 'K' && u[2] == 3 && u[3] == 4) return Compression::Zip;
+    return Compression::None;
+}
+
+// -------------------- Cola acotada de bloques --------------------
+struct ChunkQueue {
+    explicit ChunkQueue(size_t cap) : cap_(cap) {}
+
+    // Espera lugar. false si los consumidores abandonaron (abort).
+    bool push(std::string&& s) {
+        std::unique_lock<std::mutex> lk(mu_);
+        not_full_.wait(lk, [&] { return aborted_ || q_.size() < cap_; });
+        if (aborted_) return false;
+        q_.push_back(std::move(s));
+        not_empty_.notify_one();
+        return true;
+    }
+    // Espera un bloque. false cuando el productor cerró y no queda nada.
+    bool pop(std::string& s) {
+        std::unique_lock<std::mutex> lk(mu_);
+        not_empty_.wait(lk, [&] { return closed_ || aborted_ || !q_.empty(); });
+        if (q_.empty() || aborted_) return false;
+        s = std::move(q_.front());
+        q_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+    void close() {
+        std::lock_guard<std::mutex> lk(mu_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+    void abort() {
+        std::lock_guard<std::mutex> lk(mu_);
+        aborted_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    std::mutex mu_;
+    std::condition_variable not_full_, not_empty_;
+    std::deque<std::string> q_;
+    size_t cap_;
+    bool closed_ = false, aborted_ = false;
+};
+
+namespace decompress_detail {
+
+// -------------------- Bibliotecas (dlopen) --------------------
+// z_stream y los buffers de zstd con la disposición de sus ABI estables.
+struct ZStream {
+    const unsigned char* next_in;
+    unsigned avail_in;
+    unsigned long total_in;
+    unsigned char* next_out;
+    unsigned avail_out;
+    unsigned long total_out;
+    const char* msg;
+    void* state;
+    void* zalloc;
+    void* zfree;
+    void* opaque;
+    int data_type;
+    unsigned long adler;
+    unsigned long reserved;
+};
+constexpr int kZOk = 0, kZStreamEnd = 1, kZNoFlush = 0, kZBufError = -5;
+
+struct Zlib {
+    bool ok = false;
+    const char* (*version)();
+    int (*init2)(ZStream*, int, const char*, int);
+    int (*inflate)(ZStream*, int);
+    int (*reset)(ZStream*);
+    int (*end)(ZStream*);
+
+    static const Zlib& get() {
+        static const Zlib z = [] {
+            Zlib z;
+            void* h = dlopen("libz.so.1", RTLD_NOW | RTLD_LOCAL);
+            if (!h) return z;
+            z.version = reinterpret_cast<const char* (*)()>(dlsym(h, "zlibVersion"));
+            z.init2 = reinterpret_cast<int (*)(ZStream*, int, const char*, int)>(dlsym(h, "inflateInit2_"));
+            z.inflate = reinterpret_cast<int (*)(ZStream*, int)>(dlsym(h, "inflate"));
+            z.reset = reinterpret_cast<int (*)(ZStream*)>(dlsym(h, "inflateReset"));
+            z.end = reinterpret_cast<int (*)(ZStream*)>(dlsym(h, "inflateEnd"));
+            z.ok = z.version && z.init2 && z.inflate && z.reset && z.end;
+            return z;
+        }();
+        return z;
+    }
+};
+
+struct ZstdInBuffer { const void* src; size_t size; size_t pos; };
+struct ZstdOutBuffer { void* dst; size_t size; size_t pos; };
+
+struct Zstd {
+    bool ok = false;
+    void* (*create)();
+    size_t (*free)(void*);
+    size_t (*stream)(void*, ZstdOutBuffer*, ZstdInBuffer*);
+    unsigned (*is_error)(size_t);
+    const char* (*error_name)(size_t);
+
+    static const Zstd& get() {
+        static const Zstd z = [] {
+            Zstd z;
+            void* h = dlopen("libzstd.so.1", RTLD_NOW | RTLD_LOCAL);
+            if (!h) return z;
+            z.create = reinterpret_cast<void* (*)()>(dlsym(h, "ZSTD_createDStream"));
+            z.free = reinterpret_cast<size_t (*)(void*)>(dlsym(h, "ZSTD_freeDStream"));
+            z.stream = reinterpret_cast<size_t (*)(void*, ZstdOutBuffer*, ZstdInBuffer*)>(dlsym(h, "ZSTD_decompressStream"));
+            z.is_error = reinterpret_cast<unsigned (*)(size_t)>(dlsym(h, "ZSTD_isError"));
+            z.error_name = reinterpret_cast<const char* (*)(size_t)>(dlsym(h, "ZSTD_getErrorName"));
+            z.ok = z.create && z.free && z.stream && z.is_error && z.error_name;
+            return z;
+        }();
+        return z;
+    }
+};
+
+// -------------------- Decodificadores --------------------
+// read(dst, cap, got): escribe hasta cap bytes. 1 = sigue, 0 = fin del flujo, -1 = error (err).
+
+// gzip (raw = false; varios miembros concatenados se leen seguidos) o deflate crudo (zip).
+// avail_in es de 32 bits: la entrada se entrega en tramos de hasta 4 GiB - 1 y se repone
+// en read() cuando zlib agota el tramo.
+struct InflateDecoder {
+    ZStream zs{};
+    size_t left = 0;   // bytes de entrada aún no entregados a zs
+    bool raw, open = false;
+    std::string err;
+
+    InflateDecoder(const char* p, size_t n, bool raw_deflate) : left(n), raw(raw_deflate) {
+        const Zlib& Z = Zlib::get();
+        if (!Z.ok) { err = "libz.so.1 no disponible"; return; }
+        zs.next_in = reinterpret_cast<const unsigned char*>(p);
+        refill();
+        // 15 + 32: gzip o zlib según la cabecera; -15: deflate sin cabecera.
+        if (Z.init2(&zs, raw ? -15 : 15 + 32, Z.version(), (int)sizeof(ZStream)) != kZOk) {
+            err = "inflateInit2 falló";
+            return;
+        }
+        open = true;
+    }
+    ~InflateDecoder() { if (open) Zlib::get().end(&zs); }
+
+    int read(char* dst, size_t cap, size_t& got) {
+        if (!open) return -1;
+        const Zlib& Z = Zlib::get();
+        zs.next_out = reinterpret_cast<unsigned char*>(dst);
+        zs.avail_out = (unsigned)cap;
+        while (zs.avail_out > 0) {
+            refill();
+            const int r = Z.inflate(&zs, kZNoFlush);
+            const bool drained = zs.avail_in == 0 && left == 0;
+            if (r == kZStreamEnd) {
+                if (raw || drained) { got = cap - zs.avail_out; return 0; }
+                Z.reset(&zs);   // otro miembro gzip
+                continue;
+            }
+            if (r == kZBufError && drained) { err = "flujo comprimido truncado"; return -1; }
+            if (r != kZOk) { err = zs.msg ? zs.msg : "datos comprimidos inválidos"; return -1; }
+        }
+        got = cap;
+        return 1;
+    }
+
+private:
+    // next_in ya apunta al siguiente tramo: zlib lo avanza al consumir.
+    void refill() {
+        if (zs.avail_in > 0 || left == 0) return;
+        zs.avail_in = (unsigned)std::min<size_t>(left, 0xFFFFFFFFu);
+        left -= zs.avail_in;
+    }
+};
+
+struct ZstdDecoder {
+    void* ds = nullptr;
+    ZstdInBuffer in;
+    size_t hint = 1;   // última respuesta de ZSTD_decompressStream con progreso (0 = frame cerrado)
+    std::string err;
+
+    ZstdDecoder(const char* p, size_t n) : in{p, n, 0} {
+        const Zstd& Z = Zstd::get();
+        if (!Z.ok) { err = "libzstd.so.1 no disponible"; return; }
+        ds = Z.create();
+        if (!ds) err = "ZSTD_createDStream falló";
+    }
+    ~ZstdDecoder() { if (ds) Zstd::get().free(ds); }
+
+    int read(char* dst, size_t cap, size_t& got) {
+        if (!ds) return -1;
+        const Zstd& Z = Zstd::get();
+        ZstdOutBuffer out{dst, cap, 0};
+        while (out.pos < cap) {
+            // Sin entrada solo se vacía lo que el decodificador tenga guardado; si ya no
+            // sale nada, el flujo terminó (bien si el último frame quedó cerrado).
+            const size_t before = out.pos;
+            const bool more = in.pos < in.size;
+            const size_t r = Z.stream(ds, &out, &in);
+            if (Z.is_error(r)) { err = Z.error_name(r); return -1; }
+            if (more || out.pos > before) { hint = r; continue; }
+            if (hint != 0) { err = "flujo comprimido truncado"; return -1; }
+            got = out.pos;
+            return 0;
+        }
+        got = out.pos;
+        return 1;
+    }
+};
+
+struct StoredDecoder {
+    const char* p;
+    size_t left;
+    std::string err;
+
+    int read(char* dst, size_t cap, size_t& got) {
+        got = std::min(cap, left);
+        std::memcpy(dst, p, got);
+        p += got;
+        left -= got;
+        return left ? 1 : 0;
+    }
+};
+
+// -------------------- ZIP --------------------
+inline uint32_t le16(const char* p) { uint16_t v; std::memcpy(&v, p, 2); return v; }
+inline uint32_t le32(const char* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+
+// Busca la entrada a leer en el directorio central. method: 0 = stored, 8 = deflate.
+inline bool zip_entry(const char* z, size_t n, const char*& data, size_t& size, int& method, std::string& err) {
+    if (n < 22) { err = "zip truncado"; return false; }
+    size_t eocd = std::string::npos;
+    for (size_t i = n - 22 + 1; i-- > 0 && n - i <= 22 + 0xFFFF;)
+        if (le32(z + i) == 0x06054b50) { eocd = i; break; }
+    if (eocd == std::string::npos) { err = "zip sin directorio central"; return false; }
+    const uint32_t entries = le16(z + eocd + 10);
+    const uint32_t cd_off = le32(z + eocd + 16);
+    if (entries == 0xFFFF || cd_off == 0xFFFFFFFFu) { err = "ZIP64 no soportado"; return false; }
+    const char* chosen = nullptr;
+    size_t p = cd_off;
+    for (uint32_t e = 0; e < entries; ++e) {
+        if (p + 46 > n || le32(z + p) != 0x02014b50) { err = "directorio central inválido"; return false; }
+        const uint32_t nl = le16(z + p + 28), xl = le16(z + p + 30), cl = le16(z + p + 32);
+        if (p + 46 + nl > n) { err = "directorio central inválido"; return false; }
+        const std::string name(z + p + 46, nl);
+        const bool is_dir = !name.empty() && name.back() == '/';
+        const bool graph = name.size() >= 6 && name.compare(name.size() - 6, 6, ".graph") == 0;
+        if (!is_dir && (!chosen || graph)) {
+            chosen = z + p;
+            if (graph) break;
+        }
+        p += 46 + nl + xl + cl;
+    }
+    if (!chosen) { err = "zip vacío"; return false; }
+    if (le16(chosen + 8) & 1) { err = "entrada zip cifrada"; return false; }
+    method = (int)le16(chosen + 10);
+    const uint32_t csize = le32(chosen + 20), local = le32(chosen + 42);
+    if (csize == 0xFFFFFFFFu || local == 0xFFFFFFFFu) { err = "ZIP64 no soportado"; return false; }
+    if (method != 0 && method != 8) { err = "método zip no soportado (" + std::to_string(method) + ")"; return false; }
+    if ((size_t)local + 30 > n || le32(z + local) != 0x04034b50) { err = "cabecera local zip inválida"; return false; }
+    const size_t start = (size_t)local + 30 + le16(z + local + 26) + le16(z + local + 28);
+    if (start + csize > n) { err = "zip truncado"; return false; }
+    data = z + start;
+    size = csize;
+    return true;
+}
+
+// Bombea dec en bloques de ~chunk bytes que terminan en '\n' (el último, en el fin del texto).
+template <class Decoder>
+bool pump_lines(Decoder& dec, size_t chunk, const std::function<bool(std::string&&)>& emit, std::string& err) {
+    if (!dec.err.empty()) { err = dec.err; return false; }
+    constexpr size_t kStep = 1 << 18;
+    std::string block;
+    while (true) {
+        const size_t have = block.size();
+        block.resize(have + kStep);
+        size_t got = 0;
+        const int r = dec.read(block.data() + have, kStep, got);
+        block.resize(have + got);
+        if (r < 0) { err = dec.err; return false; }
+        if (r == 0) return block.empty() || emit(std::move(block));
+        if (block.size() < chunk) continue;
+        const size_t cut = block.rfind('\n');
+        if (cut == std::string::npos) continue;   // línea más larga que el bloque
+        std::string next(block, cut + 1);
+        block.resize(cut + 1);
+        if (!emit(std::move(block))) return true;   // los consumidores abandonaron
+        block = std::move(next);
+        block.reserve(chunk + kStep);
+    }
+}
+
+} // namespace decompress_detail
+
+// Descomprime [data, data + n) (formato c) y entrega bloques de líneas completas a emit;
+// si emit devuelve false se deja de descomprimir. false (con err) ante datos inválidos o
+// biblioteca ausente.
+inline bool decompress_lines(const char* data, size_t n, Compression c, size_t chunk,
+                             const std::function<bool(std::string&&)>& emit, std::string& err) {
+    using namespace decompress_detail;
+    switch (c) {
+    case Compression::Gzip: {
+        InflateDecoder d(data, n, false);
+        return pump_lines(d, chunk, emit, err);
+    }
+    case Compression::Zstd: {
+        ZstdDecoder d(data, n);
+        return pump_lines(d, chunk, emit, err);
+    }
+    case Compression::Zip: {
+        const char* p;
+        size_t k;
+        int method;
+        if (!zip_entry(data, n, p, k, method, err)) return false;
+        if (method == 0) {
+            StoredDecoder d{p, k, {}};
+            return pump_lines(d, chunk, emit, err);
+        }
+        InflateDecoder d(p, k, true);
+        return pump_lines(d, chunk, emit, err);
+    }
+    default: {
+        StoredDecoder d{data, n, {}};
+        return pump_lines(d, chunk, emit, err);
+    }
+    }
+}
@@ -1,95 +1,299 @@
-#include <bits/stdc++.h>
+// estadisticas_por_densidad.cpp
+// Resumen por densidad de uno o varios CSV de resultados (batch, run_*.sh o los de "datos *").
+//
+// Cada archivo se mapea en memoria y se recorre una vez en su propio hilo, acumulando por
+// (n, densidad) con RunningStats (Welford); los parciales se combinan con la fórmula de
+// Chan (stats.hpp). Se guardan también los valores para mediana y cuartiles.
+// n se toma del nombre de la instancia (..._n1000_...) y es 0 si no aparece.
+//
+// Columnas de entrada (por nombre en el encabezado): densidad, final_best o solucion,
+// found_at o tiempo, archivo. En los CSV de ILS el tiempo es found_at, así que mean_time es
+// el tiempo medio hasta la mejor solución.
+//
+// Compilar (Linux):
+//   g++ -O3 -march=native -std=c++20 -Wall -Wextra -pthread -o estadisticas_por_densidad estadisticas_por_densidad.cpp
+//
+// Ejecutar:
+//   ./estadisticas_por_densidad resultados.csv resumen.csv            (un archivo, como antes)
+//   ./estadisticas_por_densidad -o resumen.csv a.csv b.csv ...         (varios, combinados)
+//   ./estadisticas_por_densidad --compare -o tabla.csv
+//       det="datos determinista/resultados_globales_determinista_1000.csv"
+//       rand="datos aleatorizado/resultados_globalesRandom1000.csv"
+//       ILS="datos Iterativo/resultados1000.csv"
+//     (en una sola línea; etiqueta=archivo[,archivo...]; una fila por (n, densidad) con las
+//      columnas de cada conjunto y el método de mejor media)
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "graph_io.hpp"
+#include "stats.hpp"
+
 using namespace std;
 
-struct Stats {
-    int count = 0;
-    double sum_best = 0.0, sum_best2 = 0.0;
-    double sum_time = 0.0, sum_time2 = 0.0;
+// -------------------- Acumulación --------------------
+struct Key {
+    int n = 0;
+    double dens = 0.0;
+    bool operator<(const Key& o) const { return n != o.n ? n < o.n : dens < o.dens; }
 };
 
-int main(int argc, char* argv[]) {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+struct Group {
+    string densidad;             // tal como aparece en el CSV
+    RunningStats best, time;
+    vector<double> bests, times;
 
-    // Archivos de entrada y salida
-    string input_file = "resultados_globalesRandom3000.csv";
-    string output_file = "resumen_por_densidad_Aleatorizado_3000.csv";
+    void merge(Group&& o) {
+        if (densidad.empty()) densidad = std::move(o.densidad);
+        best.merge(o.best);
+        time.merge(o.time);
+        bests.insert(bests.end(), o.bests.begin(), o.bests.end());
+        times.insert(times.end(), o.times.begin(), o.times.end());
+    }
+};
 
-    if (argc > 1) input_file = argv[1];
-    if (argc > 2) output_file = argv[2];
+using Table = map<Key, Group>;
 
-    ifstream fin(input_file);
-    if (!fin.is_open()) {
-        cerr << " No se pudo abrir el archivo: " << input_file << "\n";
-        return 1;
+static bool parse_double(string_view s, double& x) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '"')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '"' || s.back() == '\r')) s.remove_suffix(1);
+    auto r = from_chars(s.data(), s.data() + s.size(), x);
+    return r.ec == errc() && r.ptr == s.data() + s.size();
+}
+
+// n de un nombre tipo .../erdos_n1000_p0c0.1_1.graph (0 si no hay).
+static int instance_n(string_view path) {
+    size_t slash = path.find_last_of('/');
+    if (slash != string_view::npos) path.remove_prefix(slash + 1);
+    for (size_t i = 0; i + 2 < path.size(); ++i) {
+        if (path[i] != 'n' || (i > 0 && path[i - 1] != '_')) continue;
+        int v = 0;
+        auto r = from_chars(path.data() + i + 1, path.data() + path.size(), v);
+        if (r.ec == errc() && r.ptr > path.data() + i + 1 && (r.ptr == path.data() + path.size() || *r.ptr == '_'))
+            return v;
     }
+    return 0;
+}
 
-    unordered_map<string, Stats> data;
-    string line;
-    getline(fin, line); // Saltar encabezado
+static void split(string_view line, vector<string_view>& f) {
+    f.clear();
+    size_t s = 0;
+    while (true) {
+        size_t c = line.find(',', s);
+        if (c == string_view::npos) { f.push_back(line.substr(s)); break; }
+        f.push_back(line.substr(s, c - s));
+        s = c + 1;
+    }
+    if (!f.empty() && !f.back().empty() && f.back().back() == '\r') f.back().remove_suffix(1);
+}
 
-    while (getline(fin, line)) {
-        if (line.empty()) continue;
+// Acumula un CSV en T. Devuelve false si no se pudo abrir.
+static bool read_results(const string& path, Table& T) {
+    MappedFile mf;
+    if (!mf.open(path)) return false;
+    string_view all(mf.data, mf.size);
+    vector<string_view> f;
 
-        stringstream ss(line);
-        string densidad, idx, best_str, time_str, archivo;
+    size_t pos = all.find('\n');
+    split(all.substr(0, pos), f);
+    int c_dens = 0, c_best = 2, c_time = 3, c_file = 4;
+    for (int i = 0; i < (int)f.size(); ++i) {
+        if (f[i] == "densidad") c_dens = i;
+        else if (f[i] == "final_best" || f[i] == "solucion") c_best = i;
+        else if (f[i] == "found_at" || f[i] == "tiempo") c_time = i;
+        else if (f[i] == "archivo") c_file = i;
+    }
+    const int need = max(max(c_dens, c_best), c_time);
+
+    while (pos != string_view::npos && pos + 1 < all.size()) {
+        size_t next = all.find('\n', pos + 1);
+        string_view line = all.substr(pos + 1, next == string_view::npos ? string_view::npos : next - pos - 1);
+        pos = next;
+        if (line.empty() || line == "\r") continue;
+        split(line, f);
+        if ((int)f.size() <= need) continue;
+        double d, b, t;
+        if (!parse_double(f[c_dens], d) || !parse_double(f[c_best], b) || !parse_double(f[c_time], t)) continue;  // NA
+        Key k{c_file < (int)f.size() ? instance_n(f[c_file]) : 0, d};
+        Group& g = T[k];
+        if (g.densidad.empty()) g.densidad = string(f[c_dens]);
+        g.best.add(b);
+        g.time.add(t);
+        g.bests.push_back(b);
+        g.times.push_back(t);
+    }
+    return true;
+}
 
-        getline(ss, densidad, ',');
-        getline(ss, idx, ',');
-        getline(ss, best_str, ',');
-        getline(ss, time_str, ',');
-        getline(ss, archivo, ',');
+// Lee files en paralelo (un hilo por archivo, hasta los núcleos disponibles) y combina.
+static bool read_all(const vector<string>& files, Table& out) {
+    vector<Table> part(files.size());
+    vector<char> ok(files.size(), 0);
+    atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t i; (i = next++) < files.size();) ok[i] = read_results(files[i], part[i]);
+    };
+    const int T = max(1, min((int)files.size(), (int)thread::hardware_concurrency()));
+    vector<thread> th;
+    for (int i = 1; i < T; ++i) th.emplace_back(work);
+    work();
+    for (auto& x : th) x.join();
 
-        if (best_str == "NA" || time_str == "NA") continue;
+    bool all_ok = true;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!ok[i]) {
+            cerr << " No se pudo abrir el archivo: " << files[i] << "\n";
+            all_ok = false;
+            continue;
+        }
+        for (auto& [k, g] : part[i]) out[k].merge(std::move(g));
+    }
+    for (auto& [k, g] : out) {
+        sort(g.bests.begin(), g.bests.end());
+        sort(g.times.begin(), g.times.end());
+    }
+    return all_ok;
+}
 
-        double best = stod(best_str);
-        double t = stod(time_str);
-        Stats &st = data[densidad];
-        st.count++;
-        st.sum_best += best;
-        st.sum_best2 += best * best;
-        st.sum_time += t;
-        st.sum_time2 += t * t;
+// -------------------- Salidas --------------------
+static bool write_summary(const string& path, const Table& T) {
+    ofstream fout(path);
+    if (!fout.is_open()) {
+        cerr << " No se pudo crear archivo de salida: " << path << "\n";
+        return false;
+    }
+    fout << "densidad,count,mean_best,std_best,mean_time,std_time,"
+            "median_best,q1_best,q3_best,min_best,max_best,median_time,n\n";
+    fout << fixed << setprecision(6);
+    for (const auto& [k, g] : T) {
+        fout << g.densidad << "," << g.best.n << ","
+             << g.best.mean << "," << g.best.stddev() << ","
+             << g.time.mean << "," << g.time.stddev() << ","
+             << quantile(g.bests, 0.5) << "," << quantile(g.bests, 0.25) << ","
+             << quantile(g.bests, 0.75) << "," << g.best.min << "," << g.best.max << ","
+             << quantile(g.times, 0.5) << "," << k.n << "\n";
     }
-    fin.close();
+    cout << " Archivo generado: " << path << "\n";
+    return true;
+}
+
+static int run_compare(const vector<pair<string, vector<string>>>& sets, const string& out) {
+    vector<Table> tabs(sets.size());
+    bool ok = true;
+    for (size_t s = 0; s < sets.size(); ++s) ok &= read_all(sets[s].second, tabs[s]);
+    if (!ok) return 1;
+
+    map<Key, string> keys;   // unión de (n, densidad)
+    for (const auto& T : tabs)
+        for (const auto& [k, g] : T) keys.emplace(k, g.densidad);
 
-    // Escribir salida
-    ofstream fout(output_file);
+    ofstream fout(out);
     if (!fout.is_open()) {
-        cerr << " No se pudo crear archivo de salida: " << output_file << "\n";
+        cerr << " No se pudo crear archivo de salida: " << out << "\n";
         return 1;
     }
+    fout << "n,densidad";
+    for (const auto& [label, files] : sets)
+        for (const char* c : {"count", "mean_best", "std_best", "median_best", "max_best", "mean_time"})
+            fout << "," << label << "_" << c;
+    fout << ",mejor\n";
+    fout << fixed << setprecision(6);
 
-    fout << "densidad,count,mean_best,std_best,mean_time,std_time\n";
-
-    vector<string> keys;
-    for (auto &kv : data) keys.push_back(kv.first);
-    sort(keys.begin(), keys.end());
+    cout << left << setw(6) << "n" << setw(10) << "densidad";
+    for (const auto& [label, files] : sets) cout << setw(22) << label;
+    cout << "mejor\n";
+    for (const auto& [k, dens] : keys) {
+        fout << k.n << "," << dens;
+        cout << setw(6) << k.n << setw(10) << dens;
+        string best_label;
+        double best_mean = -1.0;
+        for (size_t s = 0; s < sets.size(); ++s) {
+            auto it = tabs[s].find(k);
+            if (it == tabs[s].end()) {
+                fout << ",0,NA,NA,NA,NA,NA";
+                cout << setw(22) << "-";
+                continue;
+            }
+            const Group& g = it->second;
+            fout << "," << g.best.n << "," << g.best.mean << "," << g.best.stddev() << ","
+                 << quantile(g.bests, 0.5) << "," << g.best.max << "," << g.time.mean;
+            ostringstream cell;
+            cell << fixed << setprecision(2) << g.best.mean << " +- " << g.best.stddev();
+            cout << setw(22) << cell.str();
+            if (g.best.mean > best_mean) { best_mean = g.best.mean; best_label = sets[s].first; }
+        }
+        fout << "," << best_label << "\n";
+        cout << best_label << "\n";
+    }
+    cout << " Archivo generado: " << out << "\n";
+    return 0;
+}
 
-    for (auto &d : keys) {
-        const Stats &st = data[d];
-        if (st.count == 0) continue;
+static void print_usage() {
+    cerr << "Uso: ./estadisticas_por_densidad [entrada.csv [salida.csv]]\n"
+            "     ./estadisticas_por_densidad -o salida.csv entrada.csv...\n"
+            "     ./estadisticas_por_densidad --compare -o tabla.csv etiqueta=a.csv[,b.csv] ...\n";
+}
 
-        double mean_best = st.sum_best / st.count;
-        double mean_time = st.sum_time / st.count;
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
 
-        double var_best = (st.count > 1)
-            ? (st.sum_best2 - st.count * mean_best * mean_best) / (st.count - 1)
-            : 0.0;
-        double var_time = (st.count > 1)
-            ? (st.sum_time2 - st.count * mean_time * mean_time) / (st.count - 1)
-            : 0.0;
+    // Modo original: un archivo de entrada y uno de salida, con los mismos valores por defecto.
+    if (argc <= 3 && (argc < 2 || argv[1][0] != '-')) {
+        string input_file = "resultados_globalesRandom3000.csv";
+        string output_file = "resumen_por_densidad_Aleatorizado_3000.csv";
+        if (argc > 1) input_file = argv[1];
+        if (argc > 2) output_file = argv[2];
+        Table T;
+        if (!read_all({input_file}, T)) return 1;
+        return write_summary(output_file, T) ? 0 : 1;
+    }
 
-        double std_best = sqrt(max(0.0, var_best));
-        double std_time = sqrt(max(0.0, var_time));
+    bool compare = false;
+    string out;
+    vector<string> args;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--compare") compare = true;
+        else if (a == "-o" && i + 1 < argc) out = argv[++i];
+        else if (!a.empty() && a[0] == '-') { print_usage(); return 1; }
+        else args.push_back(a);
+    }
+    if (args.empty()) { print_usage(); return 1; }
 
-        fout << fixed << setprecision(6)
-             << d << "," << st.count << ","
-             << mean_best << "," << std_best << ","
-             << mean_time << "," << std_time << "\n";
+    if (compare) {
+        vector<pair<string, vector<string>>> sets;
+        for (const string& a : args) {
+            size_t eq = a.find('=');
+            if (eq == string::npos || eq == 0) { print_usage(); return 1; }
+            vector<string> files;
+            size_t s = eq + 1;
+            while (s <= a.size()) {
+                size_t c = a.find(',', s);
+                if (c == string::npos) c = a.size();
+                if (c > s) files.push_back(a.substr(s, c - s));
+                s = c + 1;
+            }
+            sets.push_back({a.substr(0, eq), files});
+        }
+        return run_compare(sets, out.empty() ? "comparacion_por_densidad.csv" : out);
     }
 
-    fout.close();
-    cout << " Archivo generado: " << output_file << "\n";
-    return 0;
+    Table T;
+    if (!read_all(args, T)) return 1;
+    return write_summary(out.empty() ? "resumen_por_densidad.csv" : out, T) ? 0 : 1;
 }
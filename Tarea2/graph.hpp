@@ -0,0 +1,550 @@
+// graph.hpp
+// Grafo compartido por solver, solverRandom e IterativeLocalSearch.
+//
+// Tres backends con la misma interfaz (neighbors, degree, are_adjacent, count_in, ...):
+//   - CSRGraph<Id>: offsets (n+1) + un único arreglo contiguo de vecinos, ordenados y sin
+//     duplicados por fila. Ids de 16 bits si n <= 65536, 32 bits en otro caso.
+//   - BitGraph: matriz de adyacencia densa de n x n bits (n = 3000 -> ~1.1 MB). Los conteos
+//     contra un VertexBitset son AND + popcount por palabra de 64 bits.
+//   - ComplementGraph<Id>: guarda solo el complemento (CSR) y responde por G. Para grafos
+//     muy densos ocupa una fracción de la memoria y las adyacencias salen del complemento.
+// with_loaded_graph elige el backend según la densidad (o el que se pida explícitamente) y,
+// con cache = true, lee/escribe la caché binaria de graph_cache.hpp.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "graph_cache.hpp"
+#include "graph_io.hpp"
+
+// -------------------- Conjunto de vértices (bitset) --------------------
+// Bits para las operaciones por palabra (BitGraph) y un espejo de bytes para test(),
+// que en los recorridos de listas CSR es más barato que extraer el bit.
+struct VertexBitset {
+    std::vector<uint64_t> w;
+    std::vector<char> byte;
+
+    void assign(int n) { w.assign(((size_t)n + 63) / 64, 0); byte.assign(n, 0); }
+    void clear() { std::fill(w.begin(), w.end(), 0); std::fill(byte.begin(), byte.end(), 0); }
+    bool test(int u) const { return byte[u]; }
+    void set(int u) { w[u >> 6] |= 1ULL << (u & 63); byte[u] = 1; }
+    void reset(int u) { w[u >> 6] &= ~(1ULL << (u & 63)); byte[u] = 0; }
+};
+
+// -------------------- Grafo CSR --------------------
+template <class Id>
+struct CSRGraph {
+    using id_type = Id;
+    static constexpr const char* backend_name = "csr";
+
+    int n = 0;
+    long long m = 0;
+    std::vector<uint64_t> off; // vecinos de u en nbr[off[u] .. off[u+1]) (si se armó con build)
+    std::vector<Id> nbr;
+    const uint64_t* O = nullptr; // vista usada por las consultas: off/nbr o una caché mapeada
+    const Id* A = nullptr;
+    std::vector<int> degree_order; // vértices por grado ascendente (estable); vacío si no se calculó
+
+    CSRGraph() = default;
+    CSRGraph(CSRGraph&&) = default;            // mover conserva los buffers de off/nbr
+    CSRGraph& operator=(CSRGraph&&) = default;
+    CSRGraph(const CSRGraph&) = delete;        // copiar dejaría O/A apuntando al original
+
+    std::span<const Id> neighbors(int u) const {
+        return {A + O[u], A + O[u + 1]};
+    }
+    int degree(int u) const { return (int)(O[u + 1] - O[u]); }
+    size_t memory_bytes() const { return (size_t)(n + 1) * sizeof(uint64_t) + (size_t)O[n] * sizeof(Id); }
+
+    bool are_adjacent(int u, int v) const {
+        auto L = neighbors(u);
+        return std::binary_search(L.begin(), L.end(), (Id)v);
+    }
+
+    bool is_independent(const std::vector<int>& S) const {
+        std::vector<char> mark(n, 0);
+        for (int u : S) {
+            if (mark[u]) return false;
+            for (int v : neighbors(u)) mark[v] = 1;
+        }
+        return true;
+    }
+
+    // |N(u) ∩ T|
+    int count_in(int u, const VertexBitset& T) const {
+        int c = 0;
+        for (int v : neighbors(u)) c += T.test(v);
+        return c;
+    }
+    bool intersects(int u, const VertexBitset& T) const {
+        for (int v : neighbors(u)) if (T.test(v)) return true;
+        return false;
+    }
+    // Menor v ∈ N(u) ∩ T, o -1.
+    int first_in(int u, const VertexBitset& T) const {
+        for (int v : neighbors(u)) if (T.test(v)) return v;
+        return -1;
+    }
+    // Menor v >= from con v ∈ N(a) ∩ T, v ∉ N(b) y v != b; o -1.
+    int first_in_excluding(int a, const VertexBitset& T, int b, int from) const {
+        auto L = neighbors(a);
+        for (auto it = std::lower_bound(L.begin(), L.end(), (Id)from); it != L.end(); ++it) {
+            int v = *it;
+            if (v != b && T.test(v) && !are_adjacent(b, v)) return v;
+        }
+        return -1;
+    }
+    // F ∪= N(u)
+    void mark_neighbors(int u, VertexBitset& F) const {
+        for (int v : neighbors(u)) F.set(v);
+    }
+
+    // Arma el CSR desde las aristas de read_graph_edges: pasada de conteo (un grado por
+    // vértice compartido por las partes), prefijos, pasada de llenado (el mismo arreglo como
+    // cursor de escritura), y luego orden + dedup por fila. El orden en que las partes llenan
+    // una fila no importa porque después se ordena; el scratch son N contadores sin importar
+    // cuántos hilos haya. Con un hilo se incrementan directo (atómicos costaban ~3x).
+    void build(int N, const std::vector<std::vector<int>>& parts, int threads = 0) {
+        using namespace graph_io_detail;
+        const int T = threads > 0 ? threads : default_threads();
+        const int P = (int)parts.size();
+        const int TP = std::max(1, std::min(T, P));
+        n = N;
+
+        // cnt[v] = grado (con duplicados); luego, cantidad ya escrita en la fila de v.
+        std::vector<uint32_t> cnt(N, 0);
+        auto bump = [&](int v) -> uint32_t {
+            if (TP == 1) return cnt[v]++;
+            return std::atomic_ref<uint32_t>(cnt[v]).fetch_add(1, std::memory_order_relaxed);
+        };
+        run_threads(TP, [&](int t) {
+            for (int q = t; q < P; q += TP) {
+                const auto& E = parts[q];
+                for (size_t i = 0; i < E.size(); i += 2) { bump(E[i]); bump(E[i + 1]); }
+            }
+        });
+        off.assign((size_t)N + 1, 0);
+        for (int v = 0; v < N; ++v) { off[v + 1] = off[v] + cnt[v]; cnt[v] = 0; }
+        nbr.assign(off[N], 0);
+        run_threads(TP, [&](int t) {
+            for (int q = t; q < P; q += TP) {
+                const auto& E = parts[q];
+                for (size_t i = 0; i < E.size(); i += 2) {
+                    int u = E[i], v = E[i + 1];
+                    nbr[off[u] + bump(u)] = (Id)v;
+                    nbr[off[v] + bump(v)] = (Id)u;
+                }
+            }
+        });
+        std::vector<uint32_t>().swap(cnt);
+
+        // Ordenar y deduplicar cada fila en su lugar; deg[v] = largo final.
+        std::vector<uint64_t> deg(N, 0);
+        const int TN = std::max(1, std::min(T, N));
+        run_threads(TN, [&](int t) {
+            for (int v = t; v < N; v += TN) {
+                Id* b = nbr.data() + off[v];
+                Id* e = nbr.data() + off[v + 1];
+                std::sort(b, e);
+                deg[v] = (uint64_t)(std::unique(b, e) - b);
+            }
+        });
+        // Compactar (los nuevos offsets nunca superan a los viejos).
+        uint64_t w = 0;
+        for (int v = 0; v < N; ++v) {
+            uint64_t r = off[v];
+            off[v] = w;
+            if (w != r) std::copy(nbr.begin() + r, nbr.begin() + r + deg[v], nbr.begin() + w);
+            w += deg[v];
+        }
+        off[N] = w;
+        nbr.resize(w);
+        nbr.shrink_to_fit();
+        m = (long long)(w / 2);
+        bind();
+    }
+
+    // Apunta la vista a off/nbr (después de llenarlos o moverlos).
+    void bind() { O = off.data(); A = nbr.data(); }
+
+    // Copia a off/nbr propios una vista adjunta (attach), para que G sobreviva al archivo.
+    void own() {
+        if (!off.empty() || n == 0) return;
+        off.assign(O, O + n + 1);
+        nbr.assign(A, A + O[n]);
+        bind();
+    }
+
+    // Usa los arreglos de una caché mapeada (sin copiar la adyacencia).
+    void attach(const GraphCacheView& V) {
+        off.clear(); nbr.clear();
+        n = V.n; m = V.m;
+        O = V.off;
+        A = static_cast<const Id*>(V.nbr);
+        degree_order.assign(V.order, V.order + n);
+    }
+
+    void compute_degree_order() {
+        degree_order.resize(n);
+        for (int v = 0; v < n; ++v) degree_order[v] = v;
+        std::stable_sort(degree_order.begin(), degree_order.end(),
+                         [&](int x, int y) { return degree(x) < degree(y); });
+    }
+};
+
+using Graph16 = CSRGraph<uint16_t>;
+using Graph32 = CSRGraph<uint32_t>;
+
+// -------------------- Matriz de bits --------------------
+// Recorre los bits en 1 de una fila (vecinos en orden creciente).
+struct BitRowIterator {
+    const uint64_t* row;
+    int W, i;
+    uint64_t cur;
+
+    BitRowIterator(const uint64_t* r, int words) : row(r), W(words), i(0), cur(words ? r[0] : 0) { skip(); }
+    void skip() { while (!cur && ++i < W) cur = row[i]; }
+    int operator*() const { return i * 64 + std::countr_zero(cur); }
+    BitRowIterator& operator++() { cur &= cur - 1; skip(); return *this; }
+    bool operator!=(std::default_sentinel_t) const { return i < W; }
+};
+
+struct BitRowRange {
+    const uint64_t* row;
+    int W;
+    BitRowIterator begin() const { return {row, W}; }
+    std::default_sentinel_t end() const { return {}; }
+};
+
+struct BitGraph {
+    static constexpr const char* backend_name = "bits";
+
+    int n = 0;
+    long long m = 0;
+    int W = 0;                  // palabras de 64 bits por fila
+    std::vector<uint64_t> bits; // fila u en bits[u*W .. (u+1)*W)
+    std::vector<int> deg;
+    std::vector<int> degree_order; // copiado del CSR de origen (puede estar vacío)
+
+    const uint64_t* row(int u) const { return bits.data() + (size_t)u * W; }
+    BitRowRange neighbors(int u) const { return {row(u), W}; }
+    int degree(int u) const { return deg[u]; }
+    size_t memory_bytes() const { return bits.size() * sizeof(uint64_t) + deg.size() * sizeof(int); }
+
+    bool are_adjacent(int u, int v) const { return (row(u)[v >> 6] >> (v & 63)) & 1; }
+
+    bool is_independent(const std::vector<int>& S) const {
+        VertexBitset in;
+        in.assign(n);
+        for (int u : S) {
+            if (in.test(u)) return false;
+            in.set(u);
+        }
+        for (int u : S) if (intersects(u, in)) return false;
+        return true;
+    }
+
+    int count_in(int u, const VertexBitset& T) const {
+        const uint64_t* r = row(u);
+        int c = 0;
+        for (int i = 0; i < W; ++i) c += std::popcount(r[i] & T.w[i]);
+        return c;
+    }
+    bool intersects(int u, const VertexBitset& T) const {
+        const uint64_t* r = row(u);
+        for (int i = 0; i < W; ++i) if (r[i] & T.w[i]) return true;
+        return false;
+    }
+    int first_in(int u, const VertexBitset& T) const {
+        const uint64_t* r = row(u);
+        for (int i = 0; i < W; ++i)
+            if (uint64_t x = r[i] & T.w[i]) return i * 64 + std::countr_zero(x);
+        return -1;
+    }
+    int first_in_excluding(int a, const VertexBitset& T, int b, int from) const {
+        if (from >= n) return -1;
+        const uint64_t* ra = row(a);
+        const uint64_t* rb = row(b);
+        int i = from >> 6;
+        uint64_t x = ra[i] & T.w[i] & ~rb[i] & (~0ULL << (from & 63));
+        while (true) {
+            x &= ~(i == (b >> 6) ? 1ULL << (b & 63) : 0ULL);
+            if (x) return i * 64 + std::countr_zero(x);
+            if (++i >= W) return -1;
+            x = ra[i] & T.w[i] & ~rb[i];
+        }
+    }
+    void mark_neighbors(int u, VertexBitset& F) const {
+        const uint64_t* r = row(u);
+        for (int i = 0; i < W; ++i) {
+            uint64_t fresh = r[i] & ~F.w[i];
+            F.w[i] |= fresh;
+            for (; fresh; fresh &= fresh - 1) F.byte[i * 64 + std::countr_zero(fresh)] = 1;
+        }
+    }
+
+    template <class Id>
+    void build(const CSRGraph<Id>& G) {
+        n = G.n; m = G.m;
+        W = (n + 63) / 64;
+        bits.assign((size_t)n * W, 0);
+        deg.resize(n);
+        for (int u = 0; u < n; ++u) {
+            uint64_t* r = bits.data() + (size_t)u * W;
+            for (int v : G.neighbors(u)) r[v >> 6] |= 1ULL << (v & 63);
+            deg[u] = G.degree(u);
+        }
+        degree_order = G.degree_order;
+    }
+};
+
+// -------------------- Grafo complemento --------------------
+// Vecinos de u en G = [0, n) menos la fila de u en el complemento y menos u, en orden
+// creciente (el mismo orden que CSRGraph y BitGraph, así los resultados no cambian).
+template <class Id>
+struct ComplementRowIterator {
+    const Id* h;    // próximo no-vecino (fila del complemento)
+    const Id* he;
+    int v, n, self;
+    int stop;       // próximo valor que no es vecino (min(*h, self)); ++ solo compara contra él
+
+    ComplementRowIterator(const Id* b, const Id* e, int N, int u) : h(b), he(e), v(0), n(N), self(u) {
+        stop = next_stop();
+        skip();
+    }
+    int next_stop() const {
+        int s = h < he ? (int)*h : n;
+        return (self >= v && self < s) ? self : s;
+    }
+    void skip() {
+        while (v == stop && v < n) {
+            if (h < he && (int)*h == v) ++h;
+            ++v;
+            stop = next_stop();
+        }
+    }
+    int operator*() const { return v; }
+    ComplementRowIterator& operator++() { if (++v == stop) skip(); return *this; }
+    bool operator!=(std::default_sentinel_t) const { return v < n; }
+};
+
+template <class Id>
+struct ComplementRowRange {
+    std::span<const Id> h;
+    int n, self;
+    ComplementRowIterator<Id> begin() const { return {h.data(), h.data() + h.size(), n, self}; }
+    std::default_sentinel_t end() const { return {}; }
+};
+
+template <class Id>
+struct ComplementGraph {
+    using id_type = Id;
+    static constexpr const char* backend_name = "comp";
+
+    int n = 0;
+    long long m = 0;       // aristas de G (no del complemento)
+    CSRGraph<Id> H;        // u ~H v  <=>  u != v y u, v no adyacentes en G
+    std::vector<int> degree_order;
+
+    ComplementRowRange<Id> neighbors(int u) const { return {H.neighbors(u), n, u}; }
+    int degree(int u) const { return n - 1 - H.degree(u); }
+    size_t memory_bytes() const { return H.memory_bytes(); }
+
+    bool are_adjacent(int u, int v) const { return u != v && !H.are_adjacent(u, v); }
+
+    // S es independiente en G <=> S es clique en H: |S|^2 búsquedas en filas del
+    // complemento (S es chico justamente cuando G es denso).
+    bool is_independent(const std::vector<int>& S) const {
+        for (size_t i = 0; i < S.size(); ++i)
+            for (size_t j = i + 1; j < S.size(); ++j)
+                if (S[i] == S[j] || !H.are_adjacent(S[i], S[j])) return false;
+        return true;
+    }
+
+    // |N(u) ∩ T| = |T| - [u ∈ T] - |N_H(u) ∩ T|
+    int count_in(int u, const VertexBitset& T) const {
+        int total = 0;
+        for (uint64_t x : T.w) total += std::popcount(x);
+        return total - (int)T.test(u) - H.count_in(u, T);
+    }
+    bool intersects(int u, const VertexBitset& T) const { return count_in(u, T) > 0; }
+    int first_in(int u, const VertexBitset& T) const {
+        auto L = H.neighbors(u);
+        auto h = L.begin();
+        for (size_t i = 0; i < T.w.size(); ++i) {
+            for (uint64_t x = T.w[i]; x; x &= x - 1) {
+                int v = (int)i * 64 + std::countr_zero(x);
+                while (h != L.end() && (int)*h < v) ++h;
+                if (v != u && (h == L.end() || (int)*h != v)) return v;
+            }
+        }
+        return -1;
+    }
+    // v ∉ N(b), v != b  <=>  v ∈ N_H(b): basta recorrer la fila de b en el complemento.
+    int first_in_excluding(int a, const VertexBitset& T, int b, int from) const {
+        auto L = H.neighbors(b);
+        for (auto it = std::lower_bound(L.begin(), L.end(), (Id)from); it != L.end(); ++it) {
+            int v = *it;
+            if (T.test(v) && are_adjacent(a, v)) return v;
+        }
+        return -1;
+    }
+    void mark_neighbors(int u, VertexBitset& F) const {
+        for (int v : neighbors(u)) F.set(v);
+    }
+
+    // Arma el complemento de G fila por fila (grado en H = n - 1 - grado en G).
+    void build(const CSRGraph<Id>& G, int threads = 0) {
+        using namespace graph_io_detail;
+        n = G.n; m = G.m;
+        H.n = n;
+        H.off.assign((size_t)n + 1, 0);
+        for (int u = 0; u < n; ++u) H.off[u + 1] = H.off[u] + (uint64_t)(n - 1 - G.degree(u));
+        H.nbr.assign(H.off[n], 0);
+        const int T = std::max(1, std::min(threads > 0 ? threads : default_threads(), n));
+        run_threads(T, [&](int t) {
+            for (int u = t; u < n; u += T) {
+                Id* out = H.nbr.data() + H.off[u];
+                auto L = G.neighbors(u);
+                auto g = L.begin();
+                for (int v = 0; v < n; ++v) {
+                    if (g != L.end() && (int)*g == v) { ++g; continue; }
+                    if (v != u) *out++ = (Id)v;
+                }
+            }
+        });
+        H.m = (long long)(H.off[n] / 2);
+        H.bind();
+        degree_order = G.degree_order;
+    }
+};
+
+// -------------------- Carga + elección de backend --------------------
+enum class GraphBackend { Auto, CSR, Bits, Complement };
+
+// Auto usa la matriz de bits desde esta densidad (2m / n(n-1)) y solo si n la hace chica.
+constexpr double kBitGraphMinDensity = 0.05;
+constexpr int kBitGraphMaxN = 1 << 15; // 32768^2 bits = 128 MB
+// Sobre kBitGraphMaxN, Auto guarda el complemento desde esta densidad.
+constexpr double kComplementMinDensity = 0.6;
+
+inline GraphBackend choose_backend(int n, long long m) {
+    if (n < 2) return GraphBackend::CSR;
+    double density = 2.0 * (double)m / ((double)n * (double)(n - 1));
+    if (n > kBitGraphMaxN)
+        return density >= kComplementMinDensity ? GraphBackend::Complement : GraphBackend::CSR;
+    return density >= kBitGraphMinDensity ? GraphBackend::Bits : GraphBackend::CSR;
+}
+
+inline bool parse_backend(const std::string& s, GraphBackend& b) {
+    if (s == "auto") b = GraphBackend::Auto;
+    else if (s == "csr") b = GraphBackend::CSR;
+    else if (s == "bits") b = GraphBackend::Bits;
+    else if (s == "comp") b = GraphBackend::Complement;
+    else return false;
+    return true;
+}
+
+// Llama f(B) con G convertido al backend pedido (BitGraph o ComplementGraph) o con G
+// mismo. G queda vacío si se convirtió.
+template <class Id, class F>
+void with_backend(CSRGraph<Id>& G, GraphBackend backend, int threads, F&& f) {
+    if (backend == GraphBackend::Auto) backend = choose_backend(G.n, G.m);
+    if (backend == GraphBackend::Bits && G.n <= kBitGraphMaxN) {
+        BitGraph B;
+        B.build(G);
+        G = {};
+        f(std::as_const(B));
+    } else if (backend == GraphBackend::Complement) {
+        ComplementGraph<Id> C;
+        C.build(G, threads);
+        G = {};
+        f(std::as_const(C));
+    } else {
+        f(std::as_const(G));
+    }
+}
+
+// Grafo ya convertido a su backend que se conserva después de la carga (calibrar,
+// servidor). monostate = sin grafo.
+using OwnedGraph = std::variant<std::monostate, Graph16, Graph32, BitGraph,
+                                ComplementGraph<uint16_t>, ComplementGraph<uint32_t>>;
+
+// Como with_backend, pero deja el resultado en out. G queda vacío.
+template <class Id>
+void to_owned_backend(CSRGraph<Id>& G, GraphBackend backend, int threads, OwnedGraph& out) {
+    if (backend == GraphBackend::Auto) backend = choose_backend(G.n, G.m);
+    if (backend == GraphBackend::Bits && G.n <= kBitGraphMaxN) {
+        BitGraph B;
+        B.build(G);
+        out = std::move(B);
+    } else if (backend == GraphBackend::Complement) {
+        ComplementGraph<Id> C;
+        C.build(G, threads);
+        out = std::move(C);
+    } else {
+        G.own();
+        out = std::move(G);
+    }
+    G = {};
+}
+
+// Lee la instancia y llama g(G) con el CSR (Graph16 o Graph32, modificable: g puede
+// convertirlo o vaciarlo). path puede ser un .graph o una caché .csr (se detecta por la
+// firma). Con cache = true, se usa path.csr si está vigente y si no se escribe tras armar
+// el CSR. Devuelve false si la instancia no se pudo leer.
+template <class G_>
+bool with_loaded_csr(const std::string& path, G_&& g, int threads = 0, bool cache = false) {
+    // Caché: el MappedFile debe vivir mientras se use G.
+    const bool direct = is_graph_cache_file(path);
+    if (direct || cache) {
+        MappedFile mf;
+        GraphCacheView V;
+        if (direct ? open_graph_cache(path, "", mf, V)
+                   : open_graph_cache(graph_cache_path(path), path, mf, V)) {
+            if (V.id_bytes == 2) { Graph16 G; G.attach(V); g(G); }
+            else                 { Graph32 G; G.attach(V); g(G); }
+            return true;
+        }
+        if (direct) return false;
+    }
+
+    int N = 0;
+    std::vector<std::vector<int>> parts;
+    if (!read_graph_edges(path, N, parts, threads)) return false;
+
+    auto dispatch = [&](auto& G) {
+        G.build(N, parts, threads);
+        std::vector<std::vector<int>>().swap(parts);
+        if (cache && path != "-") {
+            G.compute_degree_order();
+            using Id = typename std::decay_t<decltype(G)>::id_type;
+            if (!write_graph_cache(graph_cache_path(path), path, G.n, G.m, sizeof(Id),
+                                   G.off.data(), G.nbr.data(), G.degree_order.data()))
+                std::cerr << "No se pudo escribir la caché " << graph_cache_path(path) << "\n";
+        }
+        g(G);
+    };
+    if (N <= 65536) { Graph16 G; dispatch(G); }
+    else            { Graph32 G; dispatch(G); }
+    return true;
+}
+
+// Lee la instancia y llama f(G) con el backend elegido (Graph16, Graph32, BitGraph o
+// ComplementGraph). Devuelve false si la instancia no se pudo leer.
+template <class F>
+bool with_loaded_graph(const std::string& path, F&& f, GraphBackend backend = GraphBackend::Auto,
+                       int threads = 0, bool cache = false) {
+    return with_loaded_csr(path, [&](auto& G) { with_backend(G, backend, threads, f); }, threads, cache);
+}
@@ -0,0 +1,172 @@
+// graph_cache.hpp
+// Caché binaria del grafo ya normalizado (CSR ordenado y sin duplicados + orden por grado).
+//
+// Con --cache, la primera corrida sobre instancia.graph escribe instancia.graph.csr; las
+// siguientes lo mapean en memoria y usan los arreglos directamente, sin parsear ni ordenar.
+// La caché guarda tamaño y mtime del .graph de origen y se descarta si alguno cambió.
+//
+// Formato (little-endian, todas las secciones alineadas a 8 bytes):
+//   GraphCacheHeader | off[n+1] (u64) | nbr[off[n]] (u16 o u32) | order[n] (u32)
+// checksum = FNV-1a por palabras de 64 bits de todo lo que sigue al encabezado.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph_io.hpp"
+
+constexpr char kGraphCacheMagic[8] = {'M', 'I', 'S', 'P', 'C', 'S', 'R', '\0'};
+constexpr uint32_t kGraphCacheVersion = 1;
+
+struct GraphCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t id_bytes;      // 2 (n <= 65536) o 4
+    int64_t n;
+    int64_t m;
+    uint64_t nbr_count;     // = off[n] = 2m
+    uint64_t src_size;      // tamaño del .graph de origen
+    int64_t src_mtime_ns;   // mtime del .graph de origen
+    uint64_t checksum;
+};
+
+// Vista sobre una caché mapeada (los punteros viven mientras viva el MappedFile).
+struct GraphCacheView {
+    int n = 0;
+    long long m = 0;
+    int id_bytes = 0;
+    const uint64_t* off = nullptr;
+    const void* nbr = nullptr;
+    const uint32_t* order = nullptr;
+};
+
+namespace graph_cache_detail {
+
+inline uint64_t align8(uint64_t x) { return (x + 7) & ~7ULL; }
+
+inline uint64_t payload_bytes(int64_t n, uint64_t nbr_count, uint32_t id_bytes) {
+    return align8((uint64_t)(n + 1) * 8) + align8(nbr_count * id_bytes) + align8((uint64_t)n * 4);
+}
+
+struct Fnv64 {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    void words(const void* p, size_t bytes) {   // bytes múltiplo de 8
+        const unsigned char* c = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < bytes; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, c + i, 8);
+            h = (h ^ w) * 0x100000001b3ULL;
+        }
+    }
+};
+
+// Temporal propio de cada escritura (pid + contador): dos hilos del mismo proceso que
+// reescriben la misma caché (servidor --cache con claves distintas) no se pisan el archivo.
+inline std::string temp_path(const std::string& path) {
+    static std::atomic<uint64_t> seq{0};
+    return path + ".tmp" + std::to_string((long long)::getpid()) + "." + std::to_string(seq.fetch_add(1));
+}
+
+inline bool source_stat(const std::string& path, uint64_t& size, int64_t& mtime_ns) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    size = (uint64_t)st.st_size;
+    mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+} // namespace graph_cache_detail
+
+inline std::string graph_cache_path(const std::string& src) { return src + ".csr"; }
+
+// true si el archivo empieza con la firma de caché (para aceptar -i instancia.csr).
+inline bool is_graph_cache_file(const std::string& path) {
+    if (path == "-") return false;
+    std::ifstream in(path, std::ios::binary);
+    char magic[8];
+    return in.read(magic, 8) && std::memcmp(magic, kGraphCacheMagic, 8) == 0;
+}
+
+// Escribe la caché en path (vía archivo temporal + rename, para no dejar cachés a medias).
+// src se usa para registrar tamaño y mtime; si src está vacío no se valida al abrir.
+inline bool write_graph_cache(const std::string& path, const std::string& src, int n, long long m,
+                              uint32_t id_bytes, const uint64_t* off, const void* nbr,
+                              const int* order) {
+    using namespace graph_cache_detail;
+    GraphCacheHeader h{};
+    std::memcpy(h.magic, kGraphCacheMagic, 8);
+    h.version = kGraphCacheVersion;
+    h.id_bytes = id_bytes;
+    h.n = n;
+    h.m = m;
+    h.nbr_count = off[n];
+    h.src_size = 0; h.src_mtime_ns = 0;
+    if (!src.empty() && !source_stat(src, h.src_size, h.src_mtime_ns)) return false;
+
+    // Secciones con su relleno, en el orden del archivo.
+    std::string sec_off((const char*)off, (size_t)(n + 1) * 8);
+    std::string sec_nbr((const char*)nbr, (size_t)(h.nbr_count * id_bytes));
+    std::string sec_ord((size_t)n * 4, '\0');
+    for (int i = 0; i < n; ++i) {
+        uint32_t v = (uint32_t)order[i];
+        std::memcpy(&sec_ord[(size_t)i * 4], &v, 4);
+    }
+    for (std::string* s : {&sec_off, &sec_nbr, &sec_ord}) s->resize(align8(s->size()), '\0');
+
+    Fnv64 ck;
+    for (std::string* s : {&sec_off, &sec_nbr, &sec_ord}) ck.words(s->data(), s->size());
+    h.checksum = ck.h;
+
+    const std::string tmp = temp_path(path);
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write((const char*)&h, sizeof h);
+        for (std::string* s : {&sec_off, &sec_nbr, &sec_ord}) out.write(s->data(), (std::streamsize)s->size());
+        if (!out) { out.close(); std::remove(tmp.c_str()); return false; }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) { std::remove(tmp.c_str()); return false; }
+    return true;
+}
+
+// Mapea la caché en path y llena V. Falla si la firma, versión, tamaños o checksum no
+// cuadran, o si src no está vacío y su tamaño/mtime difiere del registrado.
+inline bool open_graph_cache(const std::string& path, const std::string& src, MappedFile& mf,
+                             GraphCacheView& V) {
+    using namespace graph_cache_detail;
+    if (!mf.open(path)) return false;
+    GraphCacheHeader h;
+    if (mf.size < sizeof h) return false;
+    std::memcpy(&h, mf.data, sizeof h);
+    if (std::memcmp(h.magic, kGraphCacheMagic, 8) != 0 || h.version != kGraphCacheVersion) return false;
+    if ((h.id_bytes != 2 && h.id_bytes != 4) || h.n <= 0 || h.n > INT32_MAX) return false;
+    if (mf.size != sizeof h + payload_bytes(h.n, h.nbr_count, h.id_bytes)) return false;
+    if (!src.empty()) {
+        uint64_t size; int64_t mtime;
+        if (!source_stat(src, size, mtime) || size != h.src_size || mtime != h.src_mtime_ns) return false;
+    }
+
+    const char* p = mf.data + sizeof h;
+    Fnv64 ck;
+    ck.words(p, mf.size - sizeof h);
+    if (ck.h != h.checksum) return false;
+
+    V.n = (int)h.n;
+    V.m = h.m;
+    V.id_bytes = (int)h.id_bytes;
+    V.off = reinterpret_cast<const uint64_t*>(p);
+    p += align8((uint64_t)(h.n + 1) * 8);
+    V.nbr = p;
+    p += align8(h.nbr_count * h.id_bytes);
+    V.order = reinterpret_cast<const uint32_t*>(p);
+    if (V.off[0] != 0 || V.off[V.n] != h.nbr_count) return false;
+    return true;
+}
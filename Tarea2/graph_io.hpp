@@ -0,0 +1,278 @@
+// graph_io.hpp
+// Lector compartido de instancias .graph para solver, solverRandom e IterativeLocalSearch.
+//
+// Formato (el mismo de IterativeLocalSearch.cpp):
+//   - Primera línea no vacía ni comentario: n
+//   - Luego: pares "u v" (0-based) hasta EOF; se permite más de un par por línea.
+//   - Líneas vacías o que comienzan con c/%/# se ignoran.
+//   - Pares inválidos, fuera de rango o lazos (u == v) se descartan.
+//
+// Ruta rápida: el archivo se mapea en memoria (mmap) y se divide por rangos de bytes
+// alineados a líneas; cada hilo parsea su rango con un escáner de enteros propio.
+// Para "-i -" (STDIN) o archivos no mapeables (pipes) se usa un lector por bloques.
+// Archivos .gz/.zst/.zip (reconocidos por su firma) se descomprimen en un hilo aparte que
+// alimenta a los parsers por una cola acotada (decompress.hpp, load_compressed).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "decompress.hpp"
+
+// -------------------- Archivo mapeado (RAII) --------------------
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    int fd = -1;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // Falla (false) si el archivo no existe, está vacío o no es mapeable (p.ej. un FIFO).
+    bool open(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) { close(); return false; }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { close(); return false; }
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(p);
+        size = (size_t)st.st_size;
+        return true;
+    }
+
+    void close() {
+        if (data) munmap(const_cast<char*>(data), size);
+        if (fd >= 0) ::close(fd);
+        data = nullptr; size = 0; fd = -1;
+    }
+};
+
+// -------------------- Escáner de enteros --------------------
+namespace graph_io_detail {
+
+inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+inline bool is_comment(char c) { return c == 'c' || c == '%' || c == '#'; }
+
+// Salta hasta después del próximo '\n' (o end).
+inline const char* next_line(const char* p, const char* end) {
+    const void* nl = memchr(p, '\n', (size_t)(end - p));
+    return nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+// Lee un token (secuencia sin blancos) con la semántica de stoi: signo opcional y
+// dígitos al inicio; el resto del token se ignora. ok=false si no hay dígitos o desborda.
+inline const char* scan_token(const char* p, const char* end, int& val, bool& ok) {
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); ++p; }
+    int64_t x = 0; ok = false;
+    bool overflow = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        x = x * 10 + (*p - '0');
+        if (x > (int64_t)INT32_MAX + 1) overflow = true, x = (int64_t)INT32_MAX + 1;
+        ok = true; ++p;
+    }
+    if (neg) x = -x;
+    if (overflow || x > INT32_MAX || x < INT32_MIN) ok = false;
+    val = (int)x;
+    while (p < end && *p != '\n' && !is_blank(*p)) ++p; // resto del token
+    return p;
+}
+
+// Busca la primera línea útil en [p,end) y lee n. Devuelve el puntero a la línea
+// siguiente, o nullptr si no hay cabecera en el rango (N = 0) o si es inválida (N = -1).
+inline const char* scan_header(const char* p, const char* end, int& N) {
+    N = 0;
+    while (p < end) {
+        while (p < end && is_blank(*p)) ++p;
+        if (p == end) break;
+        if (*p == '\n' || is_comment(*p)) { p = next_line(p, end); continue; }
+        bool ok;
+        scan_token(p, end, N, ok);
+        if (!ok) { N = -1; return nullptr; }
+        return next_line(p, end);
+    }
+    return nullptr;
+}
+
+// Parsea líneas completas de pares en [p,end) y agrega aristas válidas a out (u0,v0,u1,v1,...).
+inline void scan_pairs(const char* p, const char* end, int N, std::vector<int>& out) {
+    while (p < end) {
+        while (p < end && is_blank(*p)) ++p;
+        if (p == end) break;
+        if (*p == '\n' || is_comment(*p)) { p = next_line(p, end); continue; }
+        // Tokens de la línea tomados de a pares; un token impar al final se ignora.
+        while (p < end && *p != '\n') {
+            int u, v; bool oku, okv;
+            p = scan_token(p, end, u, oku);
+            while (p < end && is_blank(*p)) ++p;
+            if (p == end || *p == '\n') break;
+            p = scan_token(p, end, v, okv);
+            while (p < end && is_blank(*p)) ++p;
+            if (oku && okv && u >= 0 && v >= 0 && u < N && v < N && u != v) {
+                out.push_back(u);
+                out.push_back(v);
+            }
+        }
+        if (p < end) ++p; // '\n'
+    }
+}
+
+// Ejecuta f(t) para t en [0,T) en T hilos (t = 0 corre en el hilo llamador).
+template <class F>
+void run_threads(int T, F&& f) {
+    std::vector<std::thread> pool;
+    pool.reserve(T > 0 ? T - 1 : 0);
+    for (int t = 1; t < T; ++t) pool.emplace_back(f, t);
+    f(0);
+    for (auto& th : pool) th.join();
+}
+
+inline int default_threads() {
+    unsigned hc = std::thread::hardware_concurrency();
+    return hc ? (int)hc : 1;
+}
+
+// Lector por bloques (STDIN o archivos no mapeables): mismo escáner, un solo hilo.
+inline bool load_stream(std::istream& in, int& N, std::vector<std::vector<int>>& parts) {
+    constexpr size_t BLOCK = 1 << 20;
+    std::string buf;
+    std::vector<char> block(BLOCK);
+    N = 0;
+    parts.assign(1, {});
+    bool eof = false;
+    while (!eof) {
+        in.read(block.data(), (std::streamsize)BLOCK);
+        size_t got = (size_t)in.gcount();
+        eof = (got < BLOCK);
+        buf.append(block.data(), got);
+
+        // Procesar solo líneas completas; el resto queda para el próximo bloque.
+        size_t upto = eof ? buf.size() : buf.rfind('\n');
+        if (upto == std::string::npos) continue;
+        if (!eof) ++upto;
+        const char* p = buf.data();
+        const char* end = p + upto;
+        if (N <= 0) {
+            const char* q = scan_header(p, end, N);
+            if (!q) {
+                // Sin cabecera aún: si hubo un token inválido o no quedan datos, es error.
+                if (N < 0 || eof) return false;
+                buf.erase(0, upto);
+                continue;
+            }
+            p = q;
+            if (N <= 0) return false;
+        }
+        scan_pairs(p, end, N, parts[0]);
+        buf.erase(0, upto);
+    }
+    return N > 0;
+}
+
+// Pipeline para archivos comprimidos: un hilo descomprime en bloques de kInflateChunk
+// bytes cortados en fin de línea y los deja en una cola de kInflateQueue bloques; la
+// cabecera se lee del primer bloque útil y T hilos parsean el resto, cada uno en su parte.
+// Así la descompresión (secuencial) se solapa con el parseo en lugar de sumarse a él.
+constexpr size_t kInflateChunk = 4u << 20;
+constexpr size_t kInflateQueue = 8;
+
+inline bool load_compressed(const MappedFile& mf, Compression c, const std::string& path, int T,
+                            int& N, std::vector<std::vector<int>>& parts) {
+    ChunkQueue Q(kInflateQueue);
+    std::string err;
+    bool inflated = false;
+    std::thread producer([&] {
+        inflated = decompress_lines(mf.data, mf.size, c, kInflateChunk,
+                                    [&](std::string&& s) { return Q.push(std::move(s)); }, err);
+        Q.close();
+    });
+
+    std::string first;
+    const char* body = nullptr;
+    while (!body && Q.pop(first)) {
+        body = scan_header(first.data(), first.data() + first.size(), N);
+        if (N < 0) break;
+    }
+    if (!body || N <= 0) {
+        Q.abort();
+        producer.join();
+        if (!inflated && !err.empty()) std::cerr << path << ": " << err << "\n";
+        return false;
+    }
+    parts.assign(T, {});
+    run_threads(T, [&](int t) {
+        if (t == 0) scan_pairs(body, first.data() + first.size(), N, parts[0]);
+        std::string blk;
+        while (Q.pop(blk)) scan_pairs(blk.data(), blk.data() + blk.size(), N, parts[t]);
+    });
+    producer.join();
+    if (!inflated) {
+        std::cerr << path << ": " << err << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace graph_io_detail
+
+// -------------------- API --------------------
+// Lee la instancia en path ("-" = STDIN; .gz/.zst/.zip se descomprimen al vuelo) y deja
+// en parts las aristas válidas (u0,v0,u1,v1,...) repartidas por rango parseado; puede
+// haber duplicados.
+// threads <= 0 usa todos los núcleos. La adyacencia (CSR) se arma en graph.hpp.
+inline bool read_graph_edges(const std::string& path, int& N,
+                             std::vector<std::vector<int>>& parts, int threads = 0) {
+    using namespace graph_io_detail;
+    int T = threads > 0 ? threads : default_threads();
+    N = 0;
+    parts.clear();
+
+    MappedFile mf;
+    if (path != "-" && mf.open(path)) {
+        const Compression c = detect_compression(mf.data, mf.size);
+        if (c != Compression::None) return load_compressed(mf, c, path, T, N, parts);
+        const char* begin = mf.data;
+        const char* end = mf.data + mf.size;
+        const char* body = scan_header(begin, end, N);
+        if (!body || N <= 0) return false;
+
+        // Rangos de ~1 MiB como mínimo por hilo; los cortes se corren al inicio de línea.
+        const size_t bytes = (size_t)(end - body);
+        const int P = (int)std::max<size_t>(1, std::min<size_t>((size_t)T, bytes >> 20));
+        std::vector<const char*> cut(P + 1);
+        cut[0] = body; cut[P] = end;
+        for (int t = 1; t < P; ++t) {
+            const char* c = body + bytes * (size_t)t / (size_t)P;
+            if (c < cut[t - 1]) c = cut[t - 1];
+            cut[t] = (c > body && c[-1] != '\n') ? next_line(c, end) : c;
+        }
+        parts.assign(P, {});
+        run_threads(P, [&](int t) {
+            parts[t].reserve((size_t)(cut[t + 1] - cut[t]) / 4);
+            scan_pairs(cut[t], cut[t + 1], N, parts[t]);
+        });
+        mf.close();
+    } else if (path == "-") {
+        if (!load_stream(std::cin, N, parts)) return false;
+    } else {
+        std::ifstream in(path, std::ios::binary);
+        if (!in || !load_stream(in, N, parts)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+// greedy.hpp
+// Greedy determinista y aleatorizado sobre la cola por grados (bucket_queue.hpp).
+// Compartidos por solver, solverRandom y el runner batch. Graph: backend de graph.hpp.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "bucket_queue.hpp"
+
+// Toma el vértice de menor grado residual (empate: menor id, vía el índice por id de la
+// cola), lo agrega, y elimina a sus vecinos descontando el grado de los vecinos de éstos.
+// O(n + m), también con muchos vértices del mismo grado. Si S no es nulo, deja
+// ahí los vértices elegidos (arranque de ILS con --init greedy).
+template <class Graph>
+int greedy(const Graph &G, std::vector<int> *S = nullptr) {
+    DegreeBuckets Q;
+    Q.init(G.n, [&](int v) { return G.degree(v); }, true);
+    int count = 0;
+    while (!Q.empty()) {
+        int u = Q.min_vertex();
+        count++;
+        if (S) S->push_back(u);
+        Q.remove(u);
+        for (int v : G.neighbors(u)) {
+            if (!Q.removed(v)) {
+                Q.remove(v);
+                for (int w : G.neighbors(v)) {
+                    if (!Q.removed(w)) Q.decrement(w);
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// En cada paso la RCL son los size_dom = max(1, round(k * vivos)) vértices de menor grado
+// residual. Con probabilidad crit se toma el mejor (menor grado, empate menor id); si no,
+// uno uniforme de la RCL. Los candidatos se leen por rango desde la cola por grados, sin
+// sacar ni reinsertar nada, y el mejor sale del índice por id en O(1) amortizado:
+// O(n + m) más el sorteo de cada paso.
+template <class Graph>
+int greedy_randomized(const Graph &G, double crit, double k, std::mt19937_64 &gen) {
+    DegreeBuckets Q;
+    Q.init(G.n, [&](int v) { return G.degree(v); }, true);
+
+    int count = 0;
+    std::uniform_real_distribution<> dis(0.0, 1.0);
+
+    while (!Q.empty()) {
+        int size_dom = std::min(Q.size(), std::max(1, (int)std::round(k * Q.size())));
+
+        // Selección según crit
+        double delta = dis(gen);
+        int u;
+        if (delta >= crit && size_dom > 1) {
+            std::uniform_int_distribution<> pick(0, size_dom - 1);
+            u = Q.at(pick(gen));
+        } else {
+            u = Q.min_vertex();
+        }
+
+        // Selección del nodo
+        count++;
+        Q.remove(u);
+        for (int v : G.neighbors(u)) {
+            if (!Q.removed(v)) {
+                Q.remove(v);
+                for (int w : G.neighbors(v)) {
+                    if (!Q.removed(w)) Q.decrement(w);
+                }
+            }
+        }
+    }
+    return count;
+}
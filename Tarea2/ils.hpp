@@ -0,0 +1,811 @@
+// ils.hpp
+// Iterated Local Search para MISP, compartido por IterativeLocalSearch y el runner batch.
+//   - MISState: solución actual con estructuras incrementales (libres, 1-tight, journal).
+//   - ILS_MIS: un walker (construcción + LS + perturbación con aceptación).
+//   - AdaptiveControl: k de perturbación y aceptación reactivos (--adaptive).
+//   - run_ils_portfolio: N walkers en hilos que publican en un Incumbent compartido.
+//   - Con ILSParams::trace, cada walker anota un evento por iteración (trace.hpp).
+//   - Con ILSParams::checkpoint / resume, los walkers guardan y retoman su estado
+//     (checkpoint.hpp).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "bucket_queue.hpp"
+#include "checkpoint.hpp"
+#include "graph.hpp"
+#include "trace.hpp"
+
+// -------------------- Timer --------------------
+struct Timer {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point t0;
+    Timer() : t0(Clock::now()) {}
+    void reset() { t0 = Clock::now(); }
+    // Como si la corrida llevara s segundos (--resume).
+    void set_elapsed(double s) {
+        t0 = Clock::now() - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(s));
+    }
+    double elapsed() const {
+        using namespace std::chrono;
+        return duration<double>(Clock::now() - t0).count();
+    }
+    uint64_t elapsed_ns() const {
+        using namespace std::chrono;
+        return (uint64_t)duration_cast<nanoseconds>(Clock::now() - t0).count();
+    }
+};
+
+// Lectura espaciada del reloj para el bucle ILS: se consulta cada `every` iteraciones y
+// `every` se recalibra en cada lectura para que entre dos lecturas pasen ~kClockPollSec.
+// Así el tope de tiempo se pasa a lo más por ~1 ms sin leer steady_clock por iteración.
+constexpr double kClockPollSec = 1e-3;
+constexpr long long kClockPollMax = 4096;
+
+struct ClockPoll {
+    const Timer& tim;
+    double t_end;
+    long long next = 0, last_iter = 0, every = 1;
+    double last_t;
+
+    ClockPoll(const Timer& t, double end) : tim(t), t_end(end), last_t(t.elapsed()) {}
+
+    bool expired(long long it) {
+        if (it < next) return false;
+        const double t = tim.elapsed();
+        if (t >= t_end) return true;
+        if (it > last_iter && t > last_t) {
+            const double per_iter = (t - last_t) / (double)(it - last_iter);
+            every = std::clamp((long long)(kClockPollSec / per_iter), 1LL, kClockPollMax);
+        }
+        last_t = t; last_iter = it;
+        next = it + every;
+        return false;
+    }
+};
+
+// -------------------- Estado incremental de la solución --------------------
+// Estructuras al estilo Andrade–Resende–Werneck para la búsqueda local:
+//   - perm = [ S | libres | resto ] con pos[v] = índice de v en perm; mover un vértice
+//     entre zonas es O(1) (intercambio con el borde de la zona).
+//   - tight[v] = vecinos de v en S; mate[v] = suma de ids de esos vecinos, de modo que
+//     si tight[v] == 1, mate[v] es el único vecino en S.
+//   - bucket[x] (x ∈ S) = vecinos 1-tight de x, con índice bpos.
+//   - dirty = vértices de S cuyo bucket creció y deben revisarse para un (1,2)-swap.
+//   - journal = movimientos desde el último commit(), para deshacerlos con rollback().
+// Agregar/quitar un vértice cuesta O(grado); buscar un swap en x cuesta O(|bucket[x]|^2)
+// tests de adyacencia. El estado vive toda la corrida: solo reset() cuesta O(n + m).
+template <class Graph>
+struct MISState {
+    const Graph& G;
+    int n;
+    std::vector<int> perm, pos;
+    int sz = 0, nfree = 0;
+    std::vector<int> tight;
+    std::vector<long long> mate;
+    std::vector<std::vector<int>> bucket;
+    std::vector<int> bpos;
+    VertexBitset inS;
+    std::vector<int> dirty;
+    std::vector<char> in_dirty;
+    std::vector<int> journal; // ~v = add(v) deshacible; v = remove(v) deshacible
+
+    explicit MISState(const Graph& g) : G(g), n(g.n) {
+        perm.resize(n); pos.resize(n);
+        tight.assign(n, 0); mate.assign(n, 0);
+        bucket.assign(n, {}); bpos.assign(n, -1);
+        inS.assign(n);
+        in_dirty.assign(n, 0);
+    }
+
+    // Reinicia el estado a partir de un conjunto independiente S.
+    void reset(const std::vector<int>& S) {
+        std::fill(tight.begin(), tight.end(), 0);
+        std::fill(mate.begin(), mate.end(), 0);
+        for (auto& B : bucket) B.clear();
+        std::fill(bpos.begin(), bpos.end(), -1);
+        inS.clear();
+        dirty.clear();
+        std::fill(in_dirty.begin(), in_dirty.end(), 0);
+        journal.clear();
+
+        for (int x : S) inS.set(x);
+        for (int x : S)
+            for (int w : G.neighbors(x)) { tight[w]++; mate[w] += x; }
+
+        // Particionar perm en [ S | libres | resto ].
+        sz = 0; nfree = 0;
+        for (int x : S) place(x, sz++);
+        for (int v = 0; v < n; ++v) if (!inS.test(v) && tight[v] == 0) place(v, sz + nfree++);
+        int k = sz + nfree;
+        for (int v = 0; v < n; ++v) if (!inS.test(v) && tight[v] > 0) place(v, k++);
+
+        for (int v = 0; v < n; ++v)
+            if (!inS.test(v) && tight[v] == 1) bucket_add((int)mate[v], v);
+    }
+
+    int size() const { return sz; }
+    bool has_free() const { return nfree > 0; }
+    int first_free() const { return perm[sz]; }
+    bool is_free(int v) const { return pos[v] >= sz && pos[v] < sz + nfree; }
+    int sol_at(int i) const { return perm[i]; }          // i en [0, size())
+    const int* free_begin() const { return perm.data() + sz; }
+    const int* free_end() const { return perm.data() + sz + nfree; }
+
+    // Journal: checkpoint() marca, rollback() deshace hasta la marca, commit() la descarta.
+    size_t checkpoint() const { return journal.size(); }
+    void commit() { journal.clear(); }
+    void rollback(size_t mark) {
+        while (journal.size() > mark) {
+            int e = journal.back(); journal.pop_back();
+            if (e < 0) apply_remove(~e);
+            else       apply_add(e);
+        }
+    }
+
+    // Agrega u (debe ser libre) a S.
+    void add(int u) { apply_add(u); journal.push_back(~u); }
+    // Quita x de S. x queda libre (sus vecinos no están en S).
+    void remove(int x) { apply_remove(x); journal.push_back(x); }
+
+    // Busca u, v no adyacentes en bucket[x]. Cada bucket se revisa solo si creció.
+    bool find_swap(int& x, int& u, int& v) {
+        while (!dirty.empty()) {
+            x = dirty.back(); dirty.pop_back();
+            in_dirty[x] = 0;
+            if (!inS.test(x)) continue;
+            const auto& B = bucket[x];
+            for (size_t i = 0; i < B.size(); ++i)
+                for (size_t j = i + 1; j < B.size(); ++j)
+                    if (!G.are_adjacent(B[i], B[j])) { u = B[i]; v = B[j]; return true; }
+        }
+        return false;
+    }
+
+    void copy_to(std::vector<int>& S) const { S.assign(perm.begin(), perm.begin() + sz); }
+
+    // Estado entre iteraciones (journal vacío): perm, zonas, dirty y el orden de cada bucket,
+    // que es lo que decide los sorteos de perturb y los swaps de find_swap. tight, mate, pos,
+    // bpos e inS se recalculan al cargar.
+    void save(CkptWriter& w) const {
+        w.put_vec(perm);
+        w.put(sz);
+        w.put(nfree);
+        w.put_vec(dirty);
+        for (int x = 0; x < n; ++x) {
+            if (bucket[x].empty()) continue;
+            w.put(x);
+            w.put_vec(bucket[x]);
+        }
+        w.put(-1);
+    }
+    bool load(CkptReader& r) {
+        std::vector<int> P, D;
+        r.get_vec(P);
+        const int s = r.get<int>(), f = r.get<int>();
+        r.get_vec(D);
+        if (!r.ok || (int)P.size() != n || s < 0 || f < 0 || s + f > n) return false;
+        std::vector<char> seen(n, 0);
+        for (int v : P) {
+            if (v < 0 || v >= n || seen[v]) return false;
+            seen[v] = 1;
+        }
+        reset({});
+        perm = std::move(P);
+        for (int i = 0; i < n; ++i) pos[perm[i]] = i;
+        sz = s;
+        nfree = f;
+        for (int i = 0; i < sz; ++i) inS.set(perm[i]);
+        for (int i = 0; i < sz; ++i)
+            for (int w : G.neighbors(perm[i])) { tight[w]++; mate[w] += perm[i]; }
+        for (int x = r.get<int>(); r.ok && x >= 0; x = r.get<int>()) {
+            if (x >= n) return false;
+            r.get_vec(bucket[x]);
+            for (int i = 0; i < (int)bucket[x].size(); ++i) {
+                const int v = bucket[x][i];
+                if (v < 0 || v >= n) return false;
+                bpos[v] = i;
+            }
+        }
+        for (int x : D) {
+            if (x < 0 || x >= n) return false;
+            in_dirty[x] = 1;
+        }
+        dirty = std::move(D);
+        return r.ok;
+    }
+
+private:
+    void apply_add(int u) {
+        swap_at(pos[u], sz);     // primero de la zona libre
+        ++sz; --nfree;
+        inS.set(u);
+        for (int w : G.neighbors(u)) {
+            int t = ++tight[w];
+            if (t == 1) {        // 0 -> 1: deja de ser libre y entra al bucket de u
+                mate[w] += u;
+                leave_free(w);
+                bucket_add(u, w);
+            } else {
+                if (t == 2) bucket_remove((int)mate[w], w);
+                mate[w] += u;
+            }
+        }
+        mark_dirty(u);
+    }
+
+    void apply_remove(int x) {
+        swap_at(pos[x], sz - 1);
+        --sz; ++nfree;           // x queda en el primer lugar de la zona libre
+        inS.reset(x);
+        for (int w : G.neighbors(x)) {
+            int t = --tight[w];
+            mate[w] -= x;
+            if (t == 0) {        // 1 -> 0: sale del bucket de x y pasa a ser libre
+                bucket_remove(x, w);
+                enter_free(w);
+            } else if (t == 1) { // 2 -> 1: entra al bucket de su único vecino en S
+                bucket_add((int)mate[w], w);
+            }
+        }
+    }
+
+    void place(int v, int i) { perm[i] = v; pos[v] = i; }
+    void swap_at(int i, int j) {
+        int a = perm[i], b = perm[j];
+        perm[i] = b; pos[b] = i;
+        perm[j] = a; pos[a] = j;
+    }
+    // v (fuera de S) pasa de la zona libre al resto.
+    void leave_free(int v) { swap_at(pos[v], sz + nfree - 1); --nfree; }
+    // v (en el resto) pasa a la zona libre.
+    void enter_free(int v) { swap_at(pos[v], sz + nfree); ++nfree; }
+
+    void bucket_add(int x, int v) {
+        bpos[v] = (int)bucket[x].size();
+        bucket[x].push_back(v);
+        if (bucket[x].size() >= 2) mark_dirty(x);
+    }
+    void bucket_remove(int x, int v) {
+        auto& B = bucket[x];
+        int i = bpos[v], last = B.back();
+        B[i] = last; bpos[last] = i;
+        B.pop_back(); bpos[v] = -1;
+    }
+    void mark_dirty(int x) {
+        if (!in_dirty[x] && bucket[x].size() >= 2) { in_dirty[x] = 1; dirty.push_back(x); }
+    }
+};
+
+// -------------------- Incumbente compartido --------------------
+// Mejor solución global entre walkers. val se lee sin locks en cada iteración; solo
+// cuando un walker la supera se toma el mutex para copiar el conjunto e imprimir BEST,
+// así las líneas BEST salen en orden creciente y consistentes con el conjunto guardado.
+// El runner por lotes usa print = false: solo le interesa el valor final.
+// base se suma a lo impreso: vértices que la reducción ya fijó fuera del kernel.
+// Con target >= 0 (en unidades del kernel), alcanzarlo pide a todos los walkers parar.
+struct Incumbent {
+    std::atomic<int> val{-1};
+    std::mutex mu;
+    std::vector<int> set;
+    double time = 0.0;
+    bool print = true;
+    int base = 0;
+    int target = -1;
+    std::atomic<bool> stop{false};
+    std::function<void(int, double)> on_best;   // cada mejora (valor + base, tiempo), bajo mu
+
+    // Publica S si mejora al global. Devuelve true si lo hizo.
+    template <class State>
+    bool offer(const State& st, double t) {
+        if (st.size() <= val.load(std::memory_order_relaxed)) return false;
+        std::lock_guard<std::mutex> lk(mu);
+        if (st.size() <= val.load(std::memory_order_relaxed)) return false;
+        st.copy_to(set);
+        time = t;
+        val.store(st.size(), std::memory_order_release);
+        if (target >= 0 && st.size() >= target) stop.store(true, std::memory_order_relaxed);
+        if (print) std::cout << "BEST " << st.size() + base << " TIME " << std::fixed << std::setprecision(6) << t << "\n";
+        if (on_best) on_best(st.size() + base, t);
+        return true;
+    }
+
+    void copy_set(std::vector<int>& S) {
+        std::lock_guard<std::mutex> lk(mu);
+        S = set;
+    }
+
+    // Vuelve al incumbente de un checkpoint (antes de lanzar los walkers).
+    void restore(int v, const std::vector<int>& S, double t) {
+        std::lock_guard<std::mutex> lk(mu);
+        set = S;
+        time = t;
+        val.store(v, std::memory_order_release);
+        if (target >= 0 && v >= target) stop.store(true, std::memory_order_relaxed);
+    }
+};
+
+// -------------------- Control adaptativo --------------------
+// Ajusta por ventanas de `window` iteraciones la fuerza de perturbación k y la
+// probabilidad de aceptar soluciones del mismo tamaño:
+//   - si la solución actual mejoró en más del 10% de la ventana, k baja en 1 (la
+//     perturbación ya basta para salir de los óptimos locales y sobra reparación);
+//   - si no, k sube en 1 hasta k_max y p_eq se duplica hasta 0.5 (más diversificación);
+//   - al mejorar el mejor del walker se vuelve a k_base y p_eq inicial;
+//   - con k en k_max durante kAdaptRestartWindows ventanas más, pide reiniciar: el walker
+//     salta a la élite y le aplica un kick (quitar max(2 k_max, |S|/8) al azar y reparar
+//     en orden aleatorio), que cuesta O(k * grado) y no una construcción O(n * |S|).
+// k_max = min(4 k_base, |S| / 2): en grafos densos |S| es chico y cada vértice quitado
+// cuesta O(grado) en la reparación, así que el tope baja solo.
+constexpr double kAcceptEqual = 0.05;
+constexpr int kAdaptRestartWindows = 4;
+
+struct AdaptiveControl {
+    int k_base = 3, k = 3, k_max = 3;
+    int window = 100;
+    double p_eq = kAcceptEqual;
+    long long stall = 0;   // iteraciones sin mejorar el mejor del walker
+    int ups = 0;           // mejoras de la solución actual en la ventana
+    int at_max = 0;        // ventanas seguidas con k == k_max
+
+    void init(int kb, int w) {
+        k_base = k = std::max(1, kb);
+        k_max = k_base;
+        window = std::max(1, w);
+        relax();
+    }
+    void relax() { k = k_base; p_eq = kAcceptEqual; stall = 0; ups = 0; at_max = 0; }
+
+    // Devuelve true si el walker debería reiniciar.
+    bool step(bool best_improved, bool cur_improved, int size) {
+        if (best_improved) { relax(); return false; }
+        ups += cur_improved;
+        if (++stall % window) return false;
+        k_max = std::max(k_base, std::min(4 * k_base, size / 2));
+        bool restart = false;
+        if (ups * 10 > window) {
+            k = std::max(1, k - 1);
+            at_max = 0;
+        } else if (k < k_max) {
+            ++k;
+            p_eq = std::min(0.5, 2 * p_eq);
+        } else if (++at_max >= kAdaptRestartWindows) {
+            restart = true;
+        }
+        ups = 0;
+        return restart;
+    }
+};
+
+// -------------------- ILS para MISP --------------------
+// Graph: backend de graph.hpp (CSRGraph<Id> o BitGraph).
+template <class Graph>
+struct ILS_MIS {
+    const Graph& G;
+    std::mt19937_64& rng;
+    double alpha;   // controla el tamaño de RCL
+    int perturb_k;  // fuerza perturbación
+    int ls_iters;   // tope de LS
+    int verbose;
+    int restart_after = 0;  // reinicio desde la élite tras estas iteraciones sin mejora
+    bool adaptive = false;  // k y aceptación reactivos (AdaptiveControl)
+    int adapt_window = 100;
+    bool rcl_residual = false;  // RCL de construct por grado residual (si no, estático)
+    long long max_iters = 0;    // tope de iteraciones (0 = sin tope)
+    long long stagnation = 0;   // parar tras estas iteraciones sin mejorar el mejor (0 = nunca)
+    const std::vector<int>* init = nullptr;   // arranque dado (ids de búsqueda); nullptr = construct()
+    int walker_id = 0;
+    Checkpointer* ckpt = nullptr;             // entrega el estado en cada época (checkpoint.hpp)
+    const std::string* resume = nullptr;      // estado guardado desde el que seguir (--resume)
+    const char* stop_reason = "";
+    long long iters = 0;    // iteraciones ILS completadas
+    int restarts = 0;
+    int ls_adds = 0, ls_swaps = 0;   // movimientos de la última local_search
+#if MISP_TRACE
+    TraceRing* trace = nullptr;
+#endif
+
+    // any-time
+    int best_val = -1;
+    double best_time = 0.0;
+    std::vector<int> best_set;
+
+    // Estado del bucle de run (miembros para poder guardarlo y retomarlo)
+    long long since_improve = 0, best_iter = 0;
+    AdaptiveControl ctl;
+    double t_end = 0.0;        // plazo en tiempo de tim
+    uint64_t ckpt_epoch = 0;
+
+    MISState<Graph> st;   // solución actual (persistente entre iteraciones)
+    std::vector<int> order;    // vértices por grado ascendente (se calcula una vez)
+    std::vector<int> rank;     // rank[v] = posición de v en order
+    bool order_is_id = false;  // order[i] == i (grafo reetiquetado por grado)
+    std::vector<int> scratch;
+    CandidateBuckets cand_q;   // construct: candidatos por grado estático
+    DegreeBuckets resid_q;     // construct: candidatos por grado residual
+
+    ILS_MIS(const Graph& g, std::mt19937_64& r, double a, int pk, int lsi, int v)
+        : G(g), rng(r), alpha(a), perturb_k(pk), ls_iters(lsi), verbose(v), st(g) {
+        if ((int)G.degree_order.size() == G.n) {
+            order = G.degree_order;   // viene de la caché binaria o del reetiquetado
+        } else {
+            order.resize(G.n);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(),
+                        [&](int x, int y){ return G.degree(x) < G.degree(y); });
+        }
+        rank.resize(G.n);
+        order_is_id = true;
+        for (int i = 0; i < G.n; ++i) { rank[order[i]] = i; order_is_id &= order[i] == i; }
+    }
+
+    // Construcción Greedy aleatoria: en cada paso la RCL son los ceil(alpha * candidatos)
+    // de menor grado (estático, o residual con rcl_residual) y se toma uno uniforme. Los
+    // candidatos viven en una cola por clave con rango en O(1)/O(log) y baja en O(1), así
+    // que cada paso cuesta O(grado) y no O(n): la construcción completa es
+    // O(n + suma de grados de S) con grado estático y O(n + m) con residual.
+    std::vector<int> construct() {
+        std::vector<int> S;
+        if (rcl_residual) construct_from<true>(resid_q, S);
+        else              construct_from<false>(cand_q, S);
+        return S;
+    }
+
+    template <bool Residual, class Queue>
+    void construct_from(Queue& Q, std::vector<int>& S) {
+        Q.init(G.n, [&](int v) { return G.degree(v); });
+        while (!Q.empty()) {
+            int rcl = std::max(1, (int)std::ceil(alpha * (double)Q.size()));
+            rcl = std::min(rcl, Q.size());
+            std::uniform_int_distribution<int> pick(0, rcl - 1);
+            int u = Q.at(pick(rng));
+
+            S.push_back(u);
+            Q.remove(u);
+            for (int v : G.neighbors(u)) {
+                if (Q.removed(v)) continue;
+                Q.remove(v);
+                if constexpr (Residual)
+                    for (int w : G.neighbors(v)) if (!Q.removed(w)) Q.decrement(w);
+            }
+        }
+    }
+
+    // Arranque desde un conjunto dado (--init), que puede no ser independiente: sus vértices
+    // entran por grado ascendente si no chocan con los ya elegidos, así que un conjunto casi
+    // factible pierde pocos; la local_search de run completa lo que falte. O(n + suma de grados).
+    std::vector<int> repair(const std::vector<int>& S0) {
+        scratch.clear();
+        for (int u : S0) if (u >= 0 && u < G.n) scratch.push_back(u);
+        std::sort(scratch.begin(), scratch.end(), [&](int x, int y){ return rank[x] < rank[y]; });
+        st.reset({});
+        for (int u : scratch) if (st.is_free(u)) st.add(u);
+        std::vector<int> S;
+        st.copy_to(S);
+        return S;
+    }
+
+    // Búsqueda local sobre st: agrega vértices libres mientras existan; si no hay, aplica
+    // un (1,2)-swap (sacar x ∈ S, meter dos vecinos 1-tight de x no adyacentes entre sí).
+    // Cada movimiento cuenta como una iteración (tope ls_iters).
+    void local_search() {
+        int it = 0;
+        ls_adds = ls_swaps = 0;
+        while (it < ls_iters) {
+            if (st.has_free()) {
+                st.add(st.first_free());
+                ++it; ++ls_adds;
+                continue;
+            }
+            int x, u, v;
+            if (!st.find_swap(x, u, v)) break;
+            st.remove(x);
+            st.add(u);
+            st.add(v);
+            ++it; ++ls_swaps;
+        }
+    }
+
+    // Perturbación sobre st: remover k al azar; reparación greedy (grado asc) sobre los
+    // vértices que quedaron libres. Cuesta O(k * grado), no O(n + m).
+    int perturb_and_repair() { return perturb_and_repair(perturb_k); }
+    int perturb_and_repair(int k) {
+        if (st.size() == 0) return 0;
+        k = std::min<int>(k, st.size());
+        for (int i = 0; i < k; ++i) {
+            std::uniform_int_distribution<int> pick(0, st.size() - 1);
+            st.remove(st.sol_at(pick(rng)));
+        }
+
+        scratch.assign(st.free_begin(), st.free_end());
+        if (order_is_id) std::sort(scratch.begin(), scratch.end());   // rank[x] == x
+        else std::sort(scratch.begin(), scratch.end(), [&](int x, int y){ return rank[x] < rank[y]; });
+        for (int u : scratch) if (st.is_free(u)) st.add(u);
+        return k;
+    }
+
+    // Reinicio parcial: quitar k al azar y reparar en orden aleatorio (no por grado, para
+    // no volver siempre a la misma solución).
+    void kick(int k) {
+        k = std::min<int>(k, st.size());
+        for (int i = 0; i < k; ++i) {
+            std::uniform_int_distribution<int> pick(0, st.size() - 1);
+            st.remove(st.sol_at(pick(rng)));
+        }
+        scratch.assign(st.free_begin(), st.free_end());
+        std::shuffle(scratch.begin(), scratch.end(), rng);
+        for (int u : scratch) if (st.is_free(u)) st.add(u);
+    }
+
+    // Todo lo que el bucle de run necesita para seguir igual: el rng va como texto
+    // (operator<< de mt19937_64), el resto en binario. Se llama entre iteraciones.
+    void save(CkptWriter& w) const {
+        std::ostringstream os;
+        os << rng;
+        w.put(G.n);
+        w.put_str(os.str());
+        w.put(iters);
+        w.put(restarts);
+        w.put(best_val);
+        w.put(best_time);
+        w.put_vec(best_set);
+        w.put(since_improve);
+        w.put(best_iter);
+        w.put(ctl);
+        w.put(t_end);
+        st.save(w);
+    }
+    bool load(CkptReader& r) {
+        if (r.get<int>() != G.n) return false;
+        std::istringstream is(r.get_str());
+        is >> rng;
+        if (!is) return false;
+        iters = r.get<long long>();
+        restarts = r.get<int>();
+        best_val = r.get<int>();
+        best_time = r.get<double>();
+        r.get_vec(best_set);
+        since_improve = r.get<long long>();
+        best_iter = r.get<long long>();
+        ctl = r.get<AdaptiveControl>();
+        t_end = r.get<double>();
+        return r.ok && st.load(r);
+    }
+
+    void submit_checkpoint(const Timer& tim, Incumbent& inc, bool last) {
+        CkptWriter w;
+        save(w);
+        std::vector<int> inc_set;
+        int inc_val;
+        double inc_time;
+        {
+            std::lock_guard<std::mutex> lk(inc.mu);
+            inc_set = inc.set;
+            inc_val = inc.val.load(std::memory_order_relaxed);
+            inc_time = inc.time;
+        }
+        ckpt->submit(walker_id, ckpt_epoch, std::move(w.buf), tim.elapsed(), inc_val, inc_time,
+                     std::move(inc_set), last);
+    }
+
+#if MISP_TRACE
+    void record(const Timer& tim, int perturbed, uint8_t flags) {
+        TraceEvent e{};
+        e.t_ns = tim.elapsed_ns();
+        e.iter = (uint64_t)iters;
+        e.size = st.size();
+        e.adds = (uint16_t)std::min(ls_adds, 0xFFFF);
+        e.swaps = (uint16_t)std::min(ls_swaps, 0xFFFF);
+        e.perturb = (uint16_t)std::min(perturbed, 0xFFFF);
+        e.flags = flags;
+        trace->push(e);
+    }
+#endif
+
+    // Bucle principal ILS con any-time. Para por tiempo, objetivo global (inc.target),
+    // max_iters o stagnation, lo que ocurra primero. Cada candidato se arma sobre la
+    // solución actual y, si se rechaza, se deshace con el journal de st. Las mejoras se
+    // publican en inc (que imprime BEST si superan al global). Con resume, sigue desde ese
+    // estado en vez de construir; con ckpt, entrega el estado al empezar cada época y al final.
+    std::tuple<std::vector<int>, int, double> run(Timer& tim, double time_limit_sec, Incumbent& inc) {
+        std::vector<int> S;
+        bool resumed = false;
+        if (resume) {
+            CkptReader r(*resume);
+            resumed = load(r);
+            if (!resumed) std::cerr << "Aviso: estado invalido del walker " << walker_id << " en el checkpoint; parte de cero\n";
+        }
+        if (!resumed) {
+            best_val = -1; best_time = 0.0; best_set.clear();
+            iters = 0; restarts = 0;
+
+            // Construcción inicial (o arranque dado) + LS
+            S = init ? repair(*init) : construct();
+            if (!G.is_independent(S)) S.clear();
+            st.reset(S);
+            local_search();
+            st.commit();
+
+            // Reporte inicial
+            st.copy_to(best_set); best_val = st.size(); best_time = tim.elapsed();
+            const bool first_global = inc.offer(st, best_time);
+#if MISP_TRACE
+            if (trace) record(tim, 0, kTraceAccepted | kTraceImproved | (first_global ? kTraceIncumbent : 0));
+#else
+            (void)first_global;
+#endif
+            since_improve = 0; best_iter = 0;
+            ctl.init(perturb_k, adapt_window);
+            t_end = tim.elapsed() + time_limit_sec;
+        }
+
+        std::uniform_real_distribution<double> U01(0.0, 1.0);
+        ClockPoll clock(tim, t_end);
+
+        while (true) {
+            if (ckpt && ckpt->epoch() != ckpt_epoch) {
+                ckpt_epoch = ckpt->epoch();
+                submit_checkpoint(tim, inc, false);
+            }
+            if (inc.stop.load(std::memory_order_relaxed)) { stop_reason = "objetivo"; break; }
+            if (max_iters > 0 && iters >= max_iters) { stop_reason = "iteraciones"; break; }
+            if (stagnation > 0 && iters - best_iter >= stagnation) { stop_reason = "estancamiento"; break; }
+            if (clock.expired(iters)) { stop_reason = "tiempo"; break; }
+
+            const int cur = st.size();
+            const size_t mark = st.checkpoint();
+            const int perturbed = perturb_and_repair(adaptive ? ctl.k : perturb_k);
+            local_search();
+
+            uint8_t flags = 0;
+            const double p_eq = adaptive ? ctl.p_eq : kAcceptEqual;
+            const bool cur_improved = st.size() > cur;
+            if (cur_improved || (st.size() == cur && U01(rng) < p_eq)) {
+                st.commit();
+                flags |= kTraceAccepted;
+            } else {
+                st.rollback(mark);
+            }
+            ++iters;
+
+            const bool best_improved = st.size() > best_val;
+            if (best_improved) {
+                best_val = st.size();
+                best_time = tim.elapsed();
+                st.copy_to(best_set);
+                if (inc.offer(st, best_time)) flags |= kTraceIncumbent;
+                flags |= kTraceImproved;
+                since_improve = 0;
+                best_iter = iters;
+            }
+            if (adaptive) {
+                if (ctl.step(best_improved, cur_improved, st.size())) {
+                    // k ya estuvo en su tope sin resultado: kick sobre la élite (la global si
+                    // supera al walker).
+                    if (inc.val.load(std::memory_order_acquire) > best_val) inc.copy_set(S);
+                    else S = best_set;
+                    st.reset(S);
+                    kick(std::max(2 * ctl.k_max, (int)S.size() / 8));
+                    local_search();
+                    st.commit();
+                    ctl.relax();
+                    ++restarts;
+                    flags |= kTraceRestart;
+                    if (st.size() > best_val) {
+                        best_val = st.size();
+                        best_time = tim.elapsed();
+                        st.copy_to(best_set);
+                        if (inc.offer(st, best_time)) flags |= kTraceIncumbent;
+                        best_iter = iters;
+                    }
+                }
+            } else if (!best_improved && restart_after > 0 && ++since_improve >= restart_after) {
+                // Estancado: seguir desde la élite global si es mejor que la actual.
+                if (inc.val.load(std::memory_order_acquire) > st.size()) {
+                    inc.copy_set(S);
+                    st.reset(S);
+                    ++restarts;
+                    flags |= kTraceRestart;
+                }
+                since_improve = 0;
+            }
+#if MISP_TRACE
+            if (trace) record(tim, perturbed, flags);
+#else
+            (void)perturbed; (void)flags;
+#endif
+        }
+        if (ckpt) submit_checkpoint(tim, inc, true);
+        std::sort(best_set.begin(), best_set.end());
+        return {best_set, best_val, best_time};
+    }
+};
+
+// -------------------- Portafolio de walkers --------------------
+struct ILSParams {
+    uint64_t seed = 123456789ULL;
+    double alpha = 0.30;
+    int perturb_k = 3;
+    int ls_iters = 2000;
+    int verbose = 0;
+    int threads = 1;       // walkers en paralelo
+    int restart = 0;       // iteraciones sin mejora antes de reiniciar desde la élite (0 = nunca)
+    double time_limit = 10.0;
+    bool adaptive = false;    // k y aceptación reactivos (AdaptiveControl)
+    int adapt_window = 100;
+    bool rcl_residual = false;   // construct: RCL por grado residual
+    long long max_iters = 0;   // por walker (0 = sin tope)
+    long long stagnation = 0;  // por walker: iteraciones sin mejorar su mejor (0 = nunca)
+    const std::vector<int>* init = nullptr;   // arranque de todos los walkers (ids de búsqueda)
+    Checkpointer* checkpoint = nullptr;       // checkpoints periódicos (nullptr = sin)
+    const CheckpointData* resume = nullptr;   // seguir desde este checkpoint (mismos parámetros)
+    Trace* trace = nullptr;   // un TraceRing por walker (nullptr = sin traza)
+};
+
+// Walker i: semilla seed+i; el 0 usa los parámetros tal cual, el resto varía
+// perturb (+0/+1/+2) y alpha (x1, x0.5, x1.5) para diversificar el portafolio.
+// Al volver, inc tiene el mejor conjunto encontrado y su tiempo (relativo a timer).
+// Con p.resume, timer e inc vuelven a los del checkpoint antes de lanzar los walkers.
+template <class Graph>
+void run_ils_portfolio(const Graph& G, const ILSParams& p, Timer& timer, Incumbent& inc) {
+    const int T = std::max(1, p.threads);
+    if (p.resume) {
+        timer.set_elapsed(p.resume->elapsed);
+        inc.restore(p.resume->inc_val, p.resume->inc_set, p.resume->inc_time);
+    }
+    std::vector<long long> iters(T, 0);
+    std::vector<int> restarts(T, 0);
+    std::vector<const char*> reasons(T, "");
+    auto walker = [&](int i) {
+        std::mt19937_64 rng(p.seed + (uint64_t)i);
+        static const double alpha_scale[3] = {1.0, 0.5, 1.5};
+        double alpha = std::min(1.0, p.alpha * alpha_scale[i % 3]);
+        int perturb_k = p.perturb_k + (i % 3);
+        ILS_MIS<Graph> solver(G, rng, alpha, perturb_k, p.ls_iters, p.verbose);
+        solver.restart_after = p.restart;
+        solver.adaptive = p.adaptive;
+        solver.adapt_window = p.adapt_window;
+        solver.rcl_residual = p.rcl_residual;
+        solver.max_iters = p.max_iters;
+        solver.stagnation = p.stagnation;
+        solver.init = p.init;
+        solver.walker_id = i;
+        solver.ckpt = p.checkpoint;
+        if (p.resume && i < (int)p.resume->walkers.size()) solver.resume = &p.resume->walkers[i];
+#if MISP_TRACE
+        if (p.trace && i < (int)p.trace->rings.size()) solver.trace = &p.trace->rings[i];
+#endif
+        solver.run(timer, p.time_limit, inc);
+        iters[i] = solver.iters;
+        restarts[i] = solver.restarts;
+        reasons[i] = solver.stop_reason;
+    };
+    if (p.checkpoint) p.checkpoint->start();
+    std::vector<std::thread> pool;
+    for (int i = 1; i < T; ++i) pool.emplace_back(walker, i);
+    walker(0);
+    for (auto& th : pool) th.join();
+    if (p.checkpoint && !p.checkpoint->finish()) std::cerr << "Aviso: no se pudo escribir el checkpoint\n";
+
+    if (p.verbose) {
+        for (int i = 0; i < T; ++i)
+            std::cerr << "# Walker " << i << ": iters " << iters[i] << "  restarts " << restarts[i]
+                      << "  parada " << reasons[i] << "\n";
+    }
+}
@@ -0,0 +1,351 @@
+// reduce.hpp
+// Reducción (kernelización) exacta antes de ILS y de los greedy.
+//
+// Reglas, aplicadas con una cola de vértices a revisar hasta que ninguna aplica:
+//   - grado 0: v entra a la solución.
+//   - grado 1: v entra; su vecino sale.
+//   - grado 2 (vecinos a, b): si a ~ b, v entra y a, b salen; si no, se pliega: v pasa a
+//     representar {a, b} con vecinos N(a) ∪ N(b) y a, b salen del grafo.
+//   - dominación: si u ~ v y N[v] ⊆ N[u], u sale (hay un óptimo sin u). Solo se prueba
+//     para v de grado <= kReduceMaxDominationDegree, que es donde suele aplicar.
+//   - gemelos de grado 3: u, v no adyacentes con N(u) = N(v) = {a, b, c}. Si hay una
+//     arista en {a, b, c}, u y v entran; si no, se pliegan: u representa {a, b, c}.
+//
+// El log permite reconstruir: lift() recorre las entradas al revés y decide cada
+// plegado según si el vértice representante quedó en la solución. Cada plegado de grado
+// 2 aporta +1 y cada plegado de gemelos +2, sea cual sea la decisión, así que
+// |S original| = |S kernel| + offset.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+#include "relabel.hpp"
+
+constexpr int kReduceMaxDominationDegree = 32;
+
+struct Reduction {
+    enum Op : int { Include, Fold2, FoldTwin };
+    struct Entry {
+        Op op;
+        int v[5];   // Include: v; Fold2: u, a, b; FoldTwin: u, v, a, b, c
+    };
+
+    int n0 = 0;                      // grafo original
+    long long m0 = 0;
+    int offset = 0;                  // |S original| = |S kernel| + offset
+    bool reduced = false;            // false: el kernel es el grafo original
+    std::vector<int> kernel_to_orig; // id del kernel -> id original (si reduced)
+    std::vector<int> relabel;        // id de búsqueda -> id del kernel (vacío = sin reetiquetar)
+    std::vector<Entry> log;
+    std::vector<int> kernel_edges;   // aristas del kernel (u0,v0,u1,v1,...) en ids del kernel
+    int kn = 0;
+    long long km = 0;
+
+    // Estadísticas
+    int included = 0, folded2 = 0, folded_twins = 0, dominated = 0;
+    double seconds = 0.0;
+
+    bool identity() const { return !reduced; }
+    bool relabeled() const { return !relabel.empty(); }
+
+    // Solución de la búsqueda (ids del kernel, reetiquetados si relabeled()) -> solución
+    // del grafo original, ordenada.
+    std::vector<int> lift(const std::vector<int>& S) const {
+        if (!relabeled()) return lift_kernel(S);
+        std::vector<int> K;
+        K.reserve(S.size());
+        for (int x : S) K.push_back(relabel[x]);
+        std::sort(K.begin(), K.end());
+        return lift_kernel(K);
+    }
+
+    // Inverso aproximado de lift para arrancar la búsqueda desde una solución del grafo
+    // original (--init): recorre el log en orden y marca cada representante de un plegado
+    // si todos los vértices que representa están en S0; devuelve los vértices marcados del
+    // kernel en ids de búsqueda, ordenados. No tiene por qué ser independiente en el kernel
+    // (S0 puede venir de otra corrida o a medias): quien lo use debe repararlo.
+    std::vector<int> project(const std::vector<int>& S0) const {
+        std::vector<char> in(n0, 0);
+        for (int u : S0) if (u >= 0 && u < n0) in[u] = 1;
+        if (reduced) {
+            for (const Entry& e : log) {
+                const int* v = e.v;
+                if (e.op == Fold2) in[v[0]] = in[v[1]] && in[v[2]];
+                else if (e.op == FoldTwin) in[v[0]] = in[v[2]] && in[v[3]] && in[v[4]];
+            }
+        }
+        std::vector<int> old_to_new;
+        if (relabeled()) {
+            old_to_new.resize(relabel.size());
+            for (int i = 0; i < (int)relabel.size(); ++i) old_to_new[relabel[i]] = i;
+        }
+        std::vector<int> K;
+        for (int x = 0; x < kn; ++x) {
+            const int o = reduced ? kernel_to_orig[x] : x;
+            if (in[o]) K.push_back(relabeled() ? old_to_new[x] : x);
+        }
+        std::sort(K.begin(), K.end());
+        return K;
+    }
+
+    template <class Graph>
+    void run(const Graph& G);
+
+private:
+    std::vector<int> lift_kernel(const std::vector<int>& K) const {
+        if (identity()) return K;
+        std::vector<char> in(n0, 0);
+        for (int x : K) in[kernel_to_orig[x]] = 1;
+        for (auto it = log.rbegin(); it != log.rend(); ++it) {
+            const int* v = it->v;
+            switch (it->op) {
+            case Include:
+                in[v[0]] = 1;
+                break;
+            case Fold2:
+                if (in[v[0]]) { in[v[0]] = 0; in[v[1]] = in[v[2]] = 1; }
+                else          { in[v[0]] = 1; }
+                break;
+            case FoldTwin:
+                if (in[v[0]]) { in[v[0]] = 0; in[v[2]] = in[v[3]] = in[v[4]] = 1; }
+                else          { in[v[0]] = in[v[1]] = 1; }
+                break;
+            }
+        }
+        std::vector<int> S;
+        for (int u = 0; u < n0; ++u) if (in[u]) S.push_back(u);
+        return S;
+    }
+
+    // Grafo dinámico: listas ordenadas (pueden tener vecinos ya borrados) + grado vivo.
+    std::vector<std::vector<int>> adj;
+    std::vector<int> deg;
+    std::vector<char> alive, queued;
+    std::vector<int> queue;
+    std::vector<int> mark;   // marcas por sello para uniones/comparaciones
+    int stamp = 0;
+
+    void push(int v) { if (alive[v] && !queued[v]) { queued[v] = 1; queue.push_back(v); } }
+
+    // Deja en adj[v] solo vecinos vivos.
+    void compact(int v) {
+        auto& L = adj[v];
+        L.erase(std::remove_if(L.begin(), L.end(), [&](int w) { return !alive[w]; }), L.end());
+    }
+    bool adjacent(int u, int v) const {
+        const auto& L = adj[u].size() <= adj[v].size() ? adj[u] : adj[v];
+        int t = adj[u].size() <= adj[v].size() ? v : u;
+        return std::binary_search(L.begin(), L.end(), t);
+    }
+    void erase(int x) {
+        alive[x] = 0;
+        for (int y : adj[x]) if (alive[y]) { --deg[y]; push(y); }
+    }
+    void include(int v) {
+        log.push_back({Include, {v, -1, -1, -1, -1}});
+        ++offset; ++included;
+        compact(v);
+        std::vector<int> N = adj[v];
+        alive[v] = 0;
+        for (int x : N) if (alive[x]) erase(x);
+    }
+    // u pasa a tener como vecinos la unión de N(x) para x en gone (sin u ni gone), y los
+    // vértices de gone salen del grafo.
+    void merge_into(int u, std::initializer_list<int> gone) {
+        ++stamp;
+        for (int x : gone) mark[x] = stamp;
+        mark[u] = stamp;
+        std::vector<int> U;
+        for (int x : gone)
+            for (int y : adj[x])
+                if (alive[y] && mark[y] != stamp) { mark[y] = stamp; U.push_back(y); }
+        std::sort(U.begin(), U.end());
+        for (int x : gone) alive[x] = 0;
+        for (int x : gone)
+            for (int y : adj[x]) if (alive[y] && y != u) { --deg[y]; push(y); }
+        for (int y : U) {
+            auto& L = adj[y];
+            auto it = std::lower_bound(L.begin(), L.end(), u);
+            if (it == L.end() || *it != u) { L.insert(it, u); ++deg[y]; }
+            // y pudo perder a los de gone y ganar u: el grado ya quedó ajustado arriba.
+            push(y);
+        }
+        adj[u] = std::move(U);
+        deg[u] = (int)adj[u].size();
+        push(u);
+    }
+
+    bool try_degree2(int v) {
+        compact(v);
+        int a = adj[v][0], b = adj[v][1];
+        if (adjacent(a, b)) { include(v); return true; }
+        log.push_back({Fold2, {v, a, b, -1, -1}});
+        ++offset; ++folded2;
+        merge_into(v, {a, b});
+        return true;
+    }
+
+    bool try_twin(int v) {
+        compact(v);
+        const int a = adj[v][0], b = adj[v][1], c = adj[v][2];
+        // Gemelo: otro vértice de grado 3 vecino de a con N = {a, b, c}.
+        compact(a);
+        for (int u : adj[a]) {
+            if (u == v || !alive[u] || deg[u] != 3) continue;
+            compact(u);
+            if (adj[u][0] != a || adj[u][1] != b || adj[u][2] != c) continue;
+            if (adjacent(a, b) || adjacent(a, c) || adjacent(b, c)) {
+                include(v);
+                include(u);
+            } else {
+                log.push_back({FoldTwin, {v, u, a, b, c}});
+                offset += 2; ++folded_twins;
+                alive[u] = 0;   // u no tiene otros vecinos que a, b, c
+                merge_into(v, {a, b, c});
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Busca u ~ v con N[v] ⊆ N[u] y lo saca.
+    bool try_domination(int v) {
+        compact(v);
+        for (int u : adj[v]) {
+            if (!alive[u] || deg[u] < deg[v]) continue;
+            bool sub = true;
+            for (int w : adj[v])
+                if (w != u && !adjacent(u, w)) { sub = false; break; }
+            if (sub) {
+                ++dominated;
+                erase(u);
+                push(v);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+template <class Graph>
+void Reduction::run(const Graph& G) {
+    auto t0 = std::chrono::steady_clock::now();
+    n0 = G.n; m0 = G.m;
+    reduced = false;
+    offset = 0; log.clear(); kernel_to_orig.clear(); kernel_edges.clear();
+    included = folded2 = folded_twins = dominated = 0;
+
+    // Ninguna regla puede aplicar si no hay vértices de grado bajo: se evita copiar G.
+    bool any = false;
+    for (int v = 0; v < n0 && !any; ++v) any = G.degree(v) <= kReduceMaxDominationDegree;
+    if (!any) {
+        kn = n0; km = m0;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return;
+    }
+
+    adj.assign(n0, {});
+    deg.assign(n0, 0);
+    alive.assign(n0, 1);
+    queued.assign(n0, 0);
+    mark.assign(n0, 0);
+    stamp = 0;
+    for (int v = 0; v < n0; ++v) {
+        for (int w : G.neighbors(v)) adj[v].push_back(w);
+        deg[v] = (int)adj[v].size();
+        if (deg[v] <= kReduceMaxDominationDegree) push(v);
+    }
+
+    while (!queue.empty()) {
+        int v = queue.back(); queue.pop_back();
+        queued[v] = 0;
+        if (!alive[v]) continue;
+        const int d = deg[v];
+        if (d == 0) { log.push_back({Include, {v, -1, -1, -1, -1}}); ++offset; ++included; alive[v] = 0; continue; }
+        if (d == 1) { include(v); continue; }
+        if (d == 2 && try_degree2(v)) continue;
+        if (d == 3 && try_twin(v)) continue;
+        if (d <= kReduceMaxDominationDegree) try_domination(v);
+    }
+
+    // Kernel: vivos renumerados en orden creciente de id.
+    std::vector<int> id(n0, -1);
+    for (int v = 0; v < n0; ++v)
+        if (alive[v]) { id[v] = (int)kernel_to_orig.size(); kernel_to_orig.push_back(v); }
+    kn = (int)kernel_to_orig.size();
+    for (int v : kernel_to_orig)
+        for (int w : adj[v])
+            if (alive[w] && v < w) { kernel_edges.push_back(id[v]); kernel_edges.push_back(id[w]); }
+    km = (long long)kernel_edges.size() / 2;
+    reduced = kn < n0 || !log.empty();
+
+    std::vector<std::vector<int>>().swap(adj);
+    std::vector<int>().swap(deg);
+    std::vector<char>().swap(alive);
+    std::vector<char>().swap(queued);
+    std::vector<int>().swap(mark);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Reduce G en R si reduce = true y, con order != None, reetiqueta el kernel (relabel.hpp);
+// luego llama g(K) con el kernel como CSR modificable. G puede quedar vacío.
+template <class Id, class G_>
+void reduce_csr(CSRGraph<Id>& G, Reduction& R, bool reduce, VertexOrder order, int threads, G_&& g) {
+    if (reduce) R.run(G);
+    else { R.n0 = R.kn = G.n; R.m0 = R.km = G.m; }
+    auto finish = [&](CSRGraph<Id>& K) {
+        if (order == VertexOrder::None || K.n == 0) {
+            g(K);
+            return;
+        }
+        R.relabel = relabel_order(K, order);
+        CSRGraph<Id> P = permuted(K, R.relabel);
+        K = {};
+        g(P);
+    };
+    if (R.identity()) {
+        finish(G);
+        return;
+    }
+    CSRGraph<Id> K;
+    G = {};
+    K.build(R.kn, {R.kernel_edges}, threads);
+    std::vector<int>().swap(R.kernel_edges);
+    finish(K);
+}
+
+// Lee la instancia y, si reduce = true, la reduce; luego llama f(K, R) con el kernel K en
+// el backend pedido y la reducción R (identidad si no se redujo). Si el kernel quedó vacío
+// f recibe un grafo de 0 vértices. Con order != None el kernel se reetiqueta antes de
+// convertirlo (relabel.hpp) y R.lift devuelve los ids originales. Devuelve false si la
+// instancia no se pudo leer.
+template <class F>
+bool with_reduced_graph(const std::string& path, F&& f, GraphBackend backend = GraphBackend::Auto,
+                        int threads = 0, bool cache = false, bool reduce = true,
+                        VertexOrder order = VertexOrder::None) {
+    return with_loaded_csr(path, [&](auto& G) {
+        Reduction R;
+        auto call = [&](const auto& K) { f(K, std::as_const(R)); };
+        reduce_csr(G, R, reduce, order, threads, [&](auto& K) { with_backend(K, backend, threads, call); });
+    }, threads, cache);
+}
+
+// Como with_reduced_graph, pero el kernel queda en out (y la reducción en R) para usarlo
+// después de la carga: calibrar y servidor lo comparten entre corridas. Con cache, un
+// kernel que sea la vista de la caché mapeada se copia (CSRGraph::own).
+inline bool load_reduced_graph(const std::string& path, OwnedGraph& out, Reduction& R,
+                               GraphBackend backend = GraphBackend::Auto, int threads = 0,
+                               bool cache = false, bool reduce = true,
+                               VertexOrder order = VertexOrder::None) {
+    return with_loaded_csr(path, [&](auto& G) {
+        R = Reduction();
+        reduce_csr(G, R, reduce, order, threads, [&](auto& K) { to_owned_backend(K, backend, threads, out); });
+    }, threads, cache);
+}
@@ -0,0 +1,141 @@
+// relabel.hpp
+// Reetiquetado de vértices para localidad de memoria antes de la búsqueda.
+//
+// Los ids de los .graph son arbitrarios, así que las actualizaciones por vecino de la LS
+// (conflicts[v], inS[v]) y de los greedy (grado residual) saltan por toda la memoria.
+// Con un orden que junte vecinos, esos accesos caen en las mismas líneas de caché.
+//
+// Órdenes (todos deterministas):
+//   - degree:  grado ascendente (estable por id). El orden por grado del ILS pasa a ser la
+//              identidad y no hace falta ordenar por rango en construct / perturb_and_repair.
+//   - rcm:     Cuthill-McKee inverso: BFS por componente desde el vértice de menor grado,
+//              visitando vecinos por grado ascendente, y se invierte. Reduce el ancho de banda.
+//   - cluster: propagación de etiquetas (kRelabelRounds rondas); los vértices de una misma
+//              comunidad quedan contiguos, por grado ascendente dentro de cada una.
+//
+// permuted(G, new_to_old) arma el CSR reetiquetado (con degree_order); las soluciones se
+// devuelven a los ids originales con new_to_old (ver Reduction::lift).
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+
+enum class VertexOrder { None, Degree, RCM, Cluster };
+
+constexpr int kRelabelRounds = 5;
+
+inline bool parse_vertex_order(const std::string& s, VertexOrder& o) {
+    if (s == "none") o = VertexOrder::None;
+    else if (s == "degree") o = VertexOrder::Degree;
+    else if (s == "rcm") o = VertexOrder::RCM;
+    else if (s == "cluster") o = VertexOrder::Cluster;
+    else return false;
+    return true;
+}
+
+// Vértices por grado ascendente, estable por id (counting sort, O(n + grado máximo)).
+template <class Graph>
+std::vector<int> degree_sorted(const Graph& G) {
+    int maxd = 0;
+    for (int v = 0; v < G.n; ++v) maxd = std::max(maxd, G.degree(v));
+    std::vector<int> start(maxd + 2, 0);
+    for (int v = 0; v < G.n; ++v) ++start[G.degree(v) + 1];
+    for (int d = 0; d <= maxd; ++d) start[d + 1] += start[d];
+    std::vector<int> order(G.n);
+    for (int v = 0; v < G.n; ++v) order[start[G.degree(v)]++] = v;
+    return order;
+}
+
+template <class Graph>
+std::vector<int> rcm_order(const Graph& G) {
+    const std::vector<int> by_deg = degree_sorted(G);
+    std::vector<char> seen(G.n, 0);
+    std::vector<int> order;
+    order.reserve(G.n);
+    std::vector<int> nb;
+    for (int s : by_deg) {
+        if (seen[s]) continue;
+        seen[s] = 1;
+        size_t head = order.size();
+        order.push_back(s);
+        while (head < order.size()) {
+            int u = order[head++];
+            nb.clear();
+            for (int v : G.neighbors(u)) if (!seen[v]) { seen[v] = 1; nb.push_back(v); }
+            std::stable_sort(nb.begin(), nb.end(), [&](int a, int b) { return G.degree(a) < G.degree(b); });
+            order.insert(order.end(), nb.begin(), nb.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Propagación de etiquetas asíncrona en orden de id: cada vértice toma la etiqueta más
+// frecuente entre sus vecinos (empate: la menor). Las comunidades se ordenan por su menor
+// vértice y, dentro, por grado ascendente.
+template <class Graph>
+std::vector<int> cluster_order(const Graph& G) {
+    const int n = G.n;
+    std::vector<int> label(n), cnt(n, 0), touched;
+    std::iota(label.begin(), label.end(), 0);
+    for (int r = 0; r < kRelabelRounds; ++r) {
+        bool changed = false;
+        for (int u = 0; u < n; ++u) {
+            touched.clear();
+            for (int v : G.neighbors(u)) {
+                if (cnt[label[v]]++ == 0) touched.push_back(label[v]);
+            }
+            int best = label[u], best_c = 0;
+            for (int l : touched) {
+                if (cnt[l] > best_c || (cnt[l] == best_c && l < best)) { best = l; best_c = cnt[l]; }
+                cnt[l] = 0;
+            }
+            if (best != label[u]) { label[u] = best; changed = true; }
+        }
+        if (!changed) break;
+    }
+    std::vector<int> first(n, n);   // menor vértice de cada etiqueta
+    for (int v = 0; v < n; ++v) first[label[v]] = std::min(first[label[v]], v);
+    std::vector<int> order = degree_sorted(G);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return first[label[a]] < first[label[b]]; });
+    return order;
+}
+
+// new_to_old[i] = vértice original que pasa a tener id i (vacío para None).
+template <class Graph>
+std::vector<int> relabel_order(const Graph& G, VertexOrder o) {
+    switch (o) {
+    case VertexOrder::Degree:  return degree_sorted(G);
+    case VertexOrder::RCM:     return rcm_order(G);
+    case VertexOrder::Cluster: return cluster_order(G);
+    default:                   return {};
+    }
+}
+
+// CSR con u' = old_to_new[u]; filas ordenadas y degree_order calculado.
+template <class Id>
+CSRGraph<Id> permuted(const CSRGraph<Id>& G, const std::vector<int>& new_to_old) {
+    CSRGraph<Id> H;
+    H.n = G.n;
+    H.m = G.m;
+    std::vector<int> old_to_new(G.n);
+    for (int i = 0; i < G.n; ++i) old_to_new[new_to_old[i]] = i;
+    H.off.resize((size_t)G.n + 1);
+    H.off[0] = 0;
+    for (int i = 0; i < G.n; ++i) H.off[i + 1] = H.off[i] + (uint64_t)G.degree(new_to_old[i]);
+    H.nbr.resize(H.off[G.n]);
+    for (int i = 0; i < G.n; ++i) {
+        Id* row = H.nbr.data() + H.off[i];
+        Id* w = row;
+        for (int v : G.neighbors(new_to_old[i])) *w++ = (Id)old_to_new[v];
+        std::sort(row, w);
+    }
+    H.bind();
+    H.degree_order = degree_sorted(H);
+    return H;
+}
@@ -0,0 +1,724 @@
+// servidor.cpp
+// Modo servidor: un proceso residente que recibe trabajos como JSON por línea (NDJSON) por
+// stdin o por un socket Unix, mantiene los grafos ya leídos en una caché LRU y corre los
+// trabajos en un pool de hilos. Evita pagar, por cada corrida de los pipelines, el arranque
+// del proceso y el parseo del .graph (lo que hacían IterativeLocalSearch, solver y
+// solverRandom lanzados miles de veces).
+//
+// Trabajo (un objeto JSON plano por línea; todo salvo instance es opcional):
+//   {"id": "a1", "instance": "new_1000_dataset/erdos_n1000_p0c0.1_1.graph", "engine": "ILS",
+//    "time": 10, "seed": 1, "alpha": 0.5, "perturb": 3, "ls": 4000, "threads": 1,
+//    "restart": 0, "adaptive": false, "adapt_window": 100, "rcl": "static", "target": -1,
+//    "max_iters": 0, "stagnation": 0, "warm": 1, "crit": 0.7, "k": 0.2,
+//    "backend": "auto", "reduce": false, "relabel": "none", "solution": false}
+//   engine: ILS | BNB | det | rand (los mismos parámetros que las líneas de comando).
+//   {"cmd": "stats"}     estado de la caché y de la cola.
+//   {"cmd": "shutdown"}  no acepta más trabajos, termina los pendientes y sale.
+//
+// Eventos (un JSON por línea, por el mismo canal por el que llegó el trabajo):
+//   {"id":..,"event":"START","n":..,"m":..,"kernel_n":..,"cached":true,"load_s":..}
+//   {"id":..,"event":"BEST","value":..,"time":..}
+//   {"id":..,"event":"FINAL_BEST","value":..,"found_at":..,"elapsed":..[,"upper_bound":..,
+//    "optimal":..][,"solution":[...]]}
+//   {"id":..,"event":"ERROR","message":".."}
+//
+// La caché guarda el kernel ya convertido a su backend (clave: ruta, backend, reduce,
+// relabel) junto con la reducción, hasta --cache-mb; se invalida si el archivo cambia
+// (tamaño o mtime). Dos trabajos que piden el mismo grafo a la vez lo leen una sola vez.
+//
+// Compilar (Linux):
+//   g++ -O3 -march=native -std=c++20 -Wall -Wextra -pthread -o servidor servidor.cpp
+//
+// Ejecutar:
+//   ./servidor -j 8 < trabajos.ndjson > eventos.ndjson
+//   ./servidor --socket /tmp/misp.sock -j 8 --cache-mb 2048 &
+//   echo '{"id":1,"instance":"g.graph","time":5}' | nc -U /tmp/misp.sock
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "bnb.hpp"
+#include "graph.hpp"
+#include "greedy.hpp"
+#include "ils.hpp"
+#include "reduce.hpp"
+#include "solution.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// -------------------- JSON --------------------
+// Objeto plano {"k": v, ...} con valores string, número, true/false o null (sin anidar).
+// Los valores quedan como texto: strings sin comillas ni escapes, el resto tal cual.
+using JsonObject = map<string, string>;
+
+static void append_utf8(string& s, unsigned cp) {
+    if (cp < 0x80) s += (char)cp;
+    else if (cp < 0x800) { s += (char)(0xC0 | (cp >> 6)); s += (char)(0x80 | (cp & 0x3F)); }
+    else { s += (char)(0xE0 | (cp >> 12)); s += (char)(0x80 | ((cp >> 6) & 0x3F)); s += (char)(0x80 | (cp & 0x3F)); }
+}
+
+static bool parse_json_object(string_view s, JsonObject& out, string& err) {
+    size_t i = 0;
+    auto ws = [&] { while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n')) ++i; };
+    auto fail = [&](const char* m) { err = string(m) + " (columna " + to_string(i + 1) + ")"; return false; };
+    auto str = [&](string& o) {
+        if (i >= s.size() || s[i] != '"') return false;
+        ++i;
+        o.clear();
+        while (i < s.size() && s[i] != '"') {
+            char c = s[i++];
+            if (c != '\\') { o += c; continue; }
+            if (i >= s.size()) return false;
+            char e = s[i++];
+            switch (e) {
+            case 'n': o += '\n'; break;
+            case 't': o += '\t'; break;
+            case 'r': o += '\r'; break;
+            case 'b': o += '\b'; break;
+            case 'f': o += '\f'; break;
+            case 'u': {
+                unsigned cp = 0;
+                for (int d = 0; d < 4; ++d, ++i) {
+                    if (i >= s.size() || !isxdigit((unsigned char)s[i])) return fail("escape \\u inválido");
+                    cp = cp * 16 + (unsigned)(isdigit((unsigned char)s[i]) ? s[i] - '0' : (tolower((unsigned char)s[i]) - 'a' + 10));
+                }
+                append_utf8(o, cp);
+                break;
+            }
+            default: o += e;   // " \ /
+            }
+        }
+        if (i >= s.size()) return false;
+        ++i;
+        return true;
+    };
+
+    out.clear();
+    ws();
+    if (i >= s.size() || s[i] != '{') return fail("se esperaba {");
+    ++i;
+    ws();
+    if (i < s.size() && s[i] == '}') { ++i; return true; }
+    while (true) {
+        ws();
+        string key, val;
+        if (!str(key)) return err.empty() ? fail("clave inválida") : false;
+        ws();
+        if (i >= s.size() || s[i] != ':') return fail("se esperaba :");
+        ++i;
+        ws();
+        if (i < s.size() && s[i] == '"') {
+            if (!str(val)) return err.empty() ? fail("string sin cerrar") : false;
+        } else {
+            size_t b = i;
+            while (i < s.size() && s[i] != ',' && s[i] != '}' && s[i] != ' ' && s[i] != '\t') ++i;
+            val = string(s.substr(b, i - b));
+            if (val.empty() || val[0] == '{' || val[0] == '[') return fail("valor inválido (objeto plano)");
+        }
+        out[key] = val;
+        ws();
+        if (i < s.size() && s[i] == ',') { ++i; continue; }
+        if (i < s.size() && s[i] == '}') { ++i; break; }
+        return fail("se esperaba , o }");
+    }
+    ws();
+    return i == s.size() ? true : fail("texto después del objeto");
+}
+
+static string json_escape(const string& s) {
+    string o = "\"";
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') { o += '\\'; o += (char)c; }
+        else if (c == '\n') o += "\\n";
+        else if (c == '\t') o += "\\t";
+        else if (c < 0x20) { char b[8]; snprintf(b, sizeof b, "\\u%04x", c); o += b; }
+        else o += (char)c;
+    }
+    return o + "\"";
+}
+
+// El id se devuelve tal como vino: número o string.
+static string json_id(const JsonObject& J, const string& raw_id_key = "id") {
+    auto it = J.find(raw_id_key);
+    if (it == J.end()) return "null";
+    const string& v = it->second;
+    bool num = !v.empty() && v.find_first_not_of("-+.0123456789eE") == string::npos;
+    return num ? v : json_escape(v);
+}
+
+// -------------------- Canal de salida --------------------
+// Líneas completas bajo un mutex: los eventos de trabajos concurrentes no se mezclan.
+struct Sink {
+    int fd;
+    bool owned;
+    mutex mu;
+    Sink(int f, bool own) : fd(f), owned(own) {}
+    ~Sink() { if (owned) ::close(fd); }
+
+    void line(const string& s) {
+        lock_guard<mutex> lk(mu);
+        string l = s + "\n";
+        const char* p = l.data();
+        size_t left = l.size();
+        while (left > 0) {
+            ssize_t w = ::write(fd, p, left);
+            if (w <= 0) return;   // el cliente se fue: se descarta
+            p += w;
+            left -= (size_t)w;
+        }
+    }
+};
+
+// -------------------- Caché de grafos --------------------
+struct CachedGraph {
+    OwnedGraph G;
+    Reduction R;
+    size_t bytes = 0;
+    double load_s = 0.0;
+};
+
+struct FileStamp {
+    uintmax_t size = 0;
+    long long mtime = 0;
+    bool operator==(const FileStamp&) const = default;
+};
+
+static bool stamp_of(const string& path, FileStamp& st) {
+    error_code ec;
+    st.size = fs::file_size(path, ec);
+    if (ec) return false;
+    auto t = fs::last_write_time(path, ec);
+    if (ec) return false;
+    st.mtime = (long long)t.time_since_epoch().count();
+    return true;
+}
+
+// LRU por bytes. Los trabajos reciben shared_ptr: un grafo desalojado sigue vivo hasta que
+// termina el último trabajo que lo usa. Una carga en curso se comparte (shared_future).
+// Cada entrada lleva una generación: si el archivo cambia durante una carga, la entrada
+// nueva reemplaza a la vieja y el primer cargador ya no la toca al terminar.
+class GraphCache {
+public:
+    using Ptr = shared_ptr<const CachedGraph>;
+
+    explicit GraphCache(size_t cap) : cap_(cap) {}
+
+    template <class Load>
+    Ptr get(const string& key, const FileStamp& st, Load&& load, bool& hit) {
+        unique_lock<mutex> lk(mu_);
+        auto it = map_.find(key);
+        if (it != map_.end() && it->second.stamp == st) {
+            lru_.splice(lru_.begin(), lru_, it->second.pos);
+            auto fut = it->second.fut;
+            ++hits_;
+            lk.unlock();
+            hit = true;
+            return fut.get();
+        }
+        if (it != map_.end()) erase(it);
+        hit = false;
+        ++misses_;
+        promise<Ptr> pr;
+        const uint64_t gen = ++gen_;
+        lru_.push_front(key);
+        map_[key] = Entry{pr.get_future().share(), lru_.begin(), st, 0, gen};
+        lk.unlock();
+        // La entrada que insertó esta llamada, si sigue en el mapa.
+        auto mine = [&] {
+            auto e = map_.find(key);
+            return e != map_.end() && e->second.gen == gen ? e : map_.end();
+        };
+
+        // Si la carga lanza (p.ej. bad_alloc), quienes esperan reciben la excepción y la
+        // entrada se borra: el próximo trabajo con esta clave vuelve a intentar.
+        Ptr g;
+        try {
+            g = load();
+        } catch (...) {
+            pr.set_exception(current_exception());
+            lk.lock();
+            it = mine();
+            if (it != map_.end()) erase(it);
+            throw;
+        }
+        pr.set_value(g);
+
+        lk.lock();
+        it = mine();
+        if (it != map_.end()) {
+            if (!g) erase(it);   // no se pudo leer: no queda en la caché
+            else { it->second.bytes = g->bytes; bytes_ += g->bytes; }
+        }
+        evict();
+        return g;
+    }
+
+    string stats_json() {
+        lock_guard<mutex> lk(mu_);
+        ostringstream o;
+        o << "\"cache_entries\":" << map_.size() << ",\"cache_mb\":" << fixed << setprecision(2)
+          << bytes_ / 1048576.0 << ",\"cache_cap_mb\":" << cap_ / 1048576.0 << ",\"hits\":" << hits_
+          << ",\"misses\":" << misses_;
+        return o.str();
+    }
+
+private:
+    struct Entry {
+        shared_future<Ptr> fut;
+        list<string>::iterator pos;
+        FileStamp stamp;
+        size_t bytes = 0;   // 0 mientras carga
+        uint64_t gen = 0;
+    };
+
+    void erase(unordered_map<string, Entry>::iterator it) {
+        bytes_ -= it->second.bytes;
+        lru_.erase(it->second.pos);
+        map_.erase(it);
+    }
+
+    // Desaloja desde el menos usado, sin tocar cargas en curso ni la última entrada.
+    void evict() {
+        auto p = lru_.end();
+        while (bytes_ > cap_ && map_.size() > 1 && p != lru_.begin()) {
+            --p;
+            auto it = map_.find(*p);
+            if (it->second.bytes == 0) continue;
+            auto prev = p == lru_.begin() ? lru_.end() : std::prev(p);
+            erase(it);
+            if (prev == lru_.end()) break;
+            p = std::next(prev);
+        }
+    }
+
+    mutex mu_;
+    list<string> lru_;
+    unordered_map<string, Entry> map_;
+    size_t cap_;
+    size_t bytes_ = 0;
+    long long hits_ = 0, misses_ = 0;
+    uint64_t gen_ = 0;
+};
+
+// -------------------- Trabajos --------------------
+struct Job {
+    JsonObject J;
+    shared_ptr<Sink> out;
+};
+
+struct JobError {
+    string message;
+};
+
+static double num(const JsonObject& J, const string& k, double def) {
+    auto it = J.find(k);
+    if (it == J.end() || it->second == "null") return def;
+    try {
+        size_t used = 0;
+        double v = stod(it->second, &used);
+        if (used != it->second.size()) throw invalid_argument(k);
+        return v;
+    } catch (...) {
+        throw JobError{"\"" + k + "\" debe ser un número"};
+    }
+}
+
+// Campos enteros sin pasar por double (una semilla > 2^53 perdería precisión): el mismo
+// stoll/stoull que usa IterativeLocalSearch, consumiendo el valor completo.
+template <class T, class Parse>
+static T integer_field(const JsonObject& J, const string& k, T def, Parse parse) {
+    auto it = J.find(k);
+    if (it == J.end() || it->second == "null") return def;
+    try {
+        size_t used = 0;
+        T v = parse(it->second, &used);
+        if (used != it->second.size()) throw invalid_argument(k);
+        return v;
+    } catch (...) {
+        throw JobError{"\"" + k + "\" debe ser un entero"};
+    }
+}
+
+static long long integer(const JsonObject& J, const string& k, long long def) {
+    return integer_field<long long>(J, k, def, [](const string& s, size_t* u) { return stoll(s, u); });
+}
+
+static uint64_t seed_of(const JsonObject& J, uint64_t def) {
+    return integer_field<uint64_t>(J, "seed", def, [](const string& s, size_t* u) { return (uint64_t)stoull(s, u); });
+}
+
+static bool flag(const JsonObject& J, const string& k, bool def) {
+    auto it = J.find(k);
+    if (it == J.end() || it->second == "null") return def;
+    if (it->second == "true" || it->second == "1") return true;
+    if (it->second == "false" || it->second == "0") return false;
+    throw JobError{"\"" + k + "\" debe ser true o false"};
+}
+
+static string text(const JsonObject& J, const string& k, const string& def) {
+    auto it = J.find(k);
+    return it == J.end() || it->second == "null" ? def : it->second;
+}
+
+static size_t graph_bytes(const CachedGraph& c) {
+    size_t b = visit([](const auto& G) -> size_t {
+        if constexpr (is_same_v<decay_t<decltype(G)>, monostate>) return 0;
+        else return G.memory_bytes();
+    }, c.G);
+    b += (c.R.kernel_to_orig.size() + c.R.relabel.size()) * sizeof(int);
+    b += c.R.log.size() * sizeof(Reduction::Entry);
+    return b + sizeof(CachedGraph);
+}
+
+struct Server {
+    GraphCache cache;
+    bool csr_cache = false;   // usar/escribir <instancia>.csr
+
+    mutex mu;
+    condition_variable cv;
+    deque<Job> queue;
+    bool closing = false;
+    atomic<int> running{0};
+
+    explicit Server(size_t cap) : cache(cap) {}
+
+    void submit(Job j) {
+        {
+            lock_guard<mutex> lk(mu);
+            if (closing) {
+                j.out->line("{\"id\":" + json_id(j.J) + ",\"event\":\"ERROR\",\"message\":\"servidor cerrando\"}");
+                return;
+            }
+            queue.push_back(std::move(j));
+        }
+        cv.notify_one();
+    }
+
+    void close() {
+        { lock_guard<mutex> lk(mu); closing = true; }
+        cv.notify_all();
+    }
+
+    void worker() {
+        while (true) {
+            Job j;
+            {
+                unique_lock<mutex> lk(mu);
+                cv.wait(lk, [&] { return closing || !queue.empty(); });
+                if (queue.empty()) return;
+                j = std::move(queue.front());
+                queue.pop_front();
+            }
+            ++running;
+            run(j);
+            --running;
+        }
+    }
+
+    string stats_json() {
+        size_t q;
+        { lock_guard<mutex> lk(mu); q = queue.size(); }
+        return "{\"event\":\"STATS\",\"queued\":" + to_string(q) + ",\"running\":" + to_string(running.load()) +
+               "," + cache.stats_json() + "}";
+    }
+
+    void run(Job& job) {
+        const string id = json_id(job.J);
+        auto emit = [&](const string& body) { job.out->line("{\"id\":" + id + "," + body + "}"); };
+        try {
+            const JsonObject& J = job.J;
+            const string path = text(J, "instance", "");
+            if (path.empty()) throw JobError{"falta \"instance\""};
+            const string engine = text(J, "engine", "ILS");
+            if (engine != "ILS" && engine != "BNB" && engine != "det" && engine != "rand")
+                throw JobError{"engine debe ser ILS, BNB, det o rand"};
+            GraphBackend backend = GraphBackend::Auto;
+            if (!parse_backend(text(J, "backend", "auto"), backend)) throw JobError{"backend debe ser auto, csr, bits o comp"};
+            VertexOrder order = VertexOrder::None;
+            if (!parse_vertex_order(text(J, "relabel", "none"), order)) throw JobError{"relabel debe ser none, degree, rcm o cluster"};
+            const bool reduce = flag(J, "reduce", false);
+
+            FileStamp st;
+            if (!stamp_of(path, st)) throw JobError{"no se pudo abrir " + path};
+            const string key = path + "|" + to_string((int)backend) + "|" + to_string(reduce) + "|" + to_string((int)order);
+            bool hit = false;
+            auto g = cache.get(key, st, [&]() -> GraphCache::Ptr {
+                auto c = make_shared<CachedGraph>();
+                auto t0 = chrono::steady_clock::now();
+                if (!load_reduced_graph(path, c->G, c->R, backend, 1, csr_cache, reduce, order)) return nullptr;
+                c->load_s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+                c->bytes = graph_bytes(*c);
+                return c;
+            }, hit);
+            if (!g) throw JobError{"no se pudo leer " + path};
+
+            visit([&](const auto& G) {
+                if constexpr (!is_same_v<decay_t<decltype(G)>, monostate>) solve(job, emit, engine, G, *g, hit);
+            }, g->G);
+        } catch (const JobError& e) {
+            emit("\"event\":\"ERROR\",\"message\":" + json_escape(e.message));
+        } catch (const exception& e) {
+            emit("\"event\":\"ERROR\",\"message\":" + json_escape(e.what()));
+        }
+    }
+
+    template <class Emit, class Graph>
+    void solve(Job& job, Emit& emit, const string& engine, const Graph& G, const CachedGraph& C, bool hit) {
+        const JsonObject& J = job.J;
+        const Reduction& R = C.R;
+        ostringstream s;
+        s << "\"event\":\"START\",\"n\":" << R.n0 << ",\"m\":" << R.m0 << ",\"kernel_n\":" << G.n
+          << ",\"backend\":\"" << Graph::backend_name << "\",\"cached\":" << (hit ? "true" : "false")
+          << ",\"load_s\":" << fixed << setprecision(6) << C.load_s;
+        emit(s.str());
+
+        const uint64_t seed = seed_of(J, 123456789ULL);
+        Timer timer;
+        timer.reset();
+        Incumbent inc;
+        inc.print = false;
+        inc.base = R.offset;
+        inc.on_best = [&](int v, double t) {
+            ostringstream b;
+            b << "\"event\":\"BEST\",\"value\":" << v << ",\"time\":" << fixed << setprecision(6) << t;
+            emit(b.str());
+        };
+        int ub = -1;
+        vector<int> K;   // solución en ids de búsqueda
+
+        if (engine == "det" || engine == "rand") {
+            // Mismo criterio que solver / solverRandom: solo el tamaño de la solución.
+            int val;
+            if (engine == "det") {
+                val = greedy(G);
+            } else {
+                mt19937_64 gen(seed);
+                val = greedy_randomized(G, num(J, "crit", 0.7), num(J, "k", 0.2), gen);
+            }
+            inc.val = val;
+            inc.time = timer.elapsed();
+        } else {
+            ILSParams p;
+            p.seed = seed;
+            p.time_limit = num(J, "time", 10.0);
+            if (p.time_limit <= 0) throw JobError{"time debe ser > 0"};
+            p.alpha = min(1.0, max(0.0, num(J, "alpha", p.alpha)));
+            p.perturb_k = (int)integer(J, "perturb", p.perturb_k);
+            p.ls_iters = (int)integer(J, "ls", p.ls_iters);
+            p.threads = max(1, (int)integer(J, "threads", 1));
+            p.restart = (int)integer(J, "restart", 0);
+            p.adaptive = flag(J, "adaptive", false);
+            p.adapt_window = (int)integer(J, "adapt_window", p.adapt_window);
+            const string rcl = text(J, "rcl", "static");
+            if (rcl != "static" && rcl != "residual") throw JobError{"rcl debe ser static o residual"};
+            p.rcl_residual = rcl == "residual";
+            p.max_iters = integer(J, "max_iters", 0);
+            p.stagnation = integer(J, "stagnation", 0);
+            const int target = (int)integer(J, "target", -1);
+            if (target >= 0) inc.target = max(0, target - R.offset);
+            const bool bnb = engine == "BNB";
+            if (bnb && G.n > kBitGraphMaxN) throw JobError{"BNB: el kernel tiene más de " + to_string(kBitGraphMaxN) + " vértices"};
+            const double total = p.time_limit;
+            if (bnb) p.time_limit = min(total, num(J, "warm", 0.1 * total));
+
+            if (G.n == 0) {
+                inc.val = 0;
+                ub = 0;
+            } else {
+                if (p.time_limit > 0) run_ils_portfolio(G, p, timer, inc);
+                if (bnb) {
+                    BnBSolver<Graph> B(G);
+                    B.build();
+                    vector<int> lb_set;
+                    inc.copy_set(lb_set);
+                    ub = B.run(timer, total, max(0, inc.val.load()), lb_set, inc);
+                }
+            }
+            inc.copy_set(K);
+            const Verification ver = verify_solution(G, K);
+            if (!ver.ok) throw JobError{"solución final inválida: " + ver.message()};
+        }
+
+        ostringstream f;
+        f << "\"event\":\"FINAL_BEST\",\"value\":" << inc.val.load() + R.offset << ",\"found_at\":" << fixed
+          << setprecision(6) << inc.time << ",\"elapsed\":" << timer.elapsed();
+        if (engine == "BNB")
+            f << ",\"upper_bound\":" << ub + R.offset << ",\"optimal\":" << (ub == inc.val.load() ? "true" : "false");
+        if (flag(J, "solution", false) && engine != "det" && engine != "rand") {
+            vector<int> S = R.lift(K);
+            f << ",\"solution\":[";
+            for (size_t i = 0; i < S.size(); ++i) f << (i ? "," : "") << S[i];
+            f << "]";
+        }
+        emit(f.str());
+    }
+};
+
+// -------------------- Entrada --------------------
+// Procesa una línea: trabajo, comando o error de formato. Devuelve false con shutdown.
+// Cualquier excepción se informa como ERROR de la línea: una entrada mala no tira el servidor.
+static bool handle_line(Server& srv, const string& line, const shared_ptr<Sink>& out) {
+    if (line.find_first_not_of(" \t\r") == string::npos) return true;
+    Job j;
+    try {
+        string err;
+        if (!parse_json_object(line, j.J, err)) {
+            out->line("{\"id\":null,\"event\":\"ERROR\",\"message\":" + json_escape("JSON inválido: " + err) + "}");
+            return true;
+        }
+        const string cmd = text(j.J, "cmd", "");
+        if (cmd == "stats") { out->line(srv.stats_json()); return true; }
+        if (cmd == "shutdown") return false;
+        if (!cmd.empty()) {
+            out->line("{\"id\":" + json_id(j.J) + ",\"event\":\"ERROR\",\"message\":" + json_escape("comando desconocido: " + cmd) + "}");
+            return true;
+        }
+        j.out = out;
+        srv.submit(std::move(j));
+    } catch (const exception& e) {
+        out->line("{\"id\":" + json_id(j.J) + ",\"event\":\"ERROR\",\"message\":" + json_escape(e.what()) + "}");
+    }
+    return true;
+}
+
+// Lee líneas de fd hasta EOF o shutdown. Devuelve false si llegó shutdown.
+static bool read_lines(Server& srv, int fd, const shared_ptr<Sink>& out) {
+    string buf;
+    char chunk[1 << 16];
+    while (true) {
+        ssize_t r = ::read(fd, chunk, sizeof chunk);
+        if (r <= 0) break;
+        buf.append(chunk, (size_t)r);
+        size_t b = 0, e;
+        while ((e = buf.find('\n', b)) != string::npos) {
+            if (!handle_line(srv, buf.substr(b, e - b), out)) return false;
+            b = e + 1;
+        }
+        buf.erase(0, b);
+    }
+    return buf.empty() || handle_line(srv, buf, out);
+}
+
+static void print_usage() {
+    cerr << "Uso: servidor [-j hilos] [--socket ruta] [--cache-mb MB] [--cache]\n"
+            "  Sin --socket lee trabajos JSON (uno por línea) de stdin y escribe los eventos en\n"
+            "  stdout; termina al llegar EOF o {\"cmd\":\"shutdown\"}, después de los pendientes.\n"
+            "  -j: trabajos en paralelo (por defecto, los núcleos); cada trabajo ILS usa además\n"
+            "      sus \"threads\" walkers.\n"
+            "  --cache-mb: memoria para grafos ya leídos (1024). --cache: usa las cachés .csr.\n";
+}
+
+int main(int argc, char** argv) {
+    int jobs = 0;
+    string socket_path;
+    double cache_mb = 1024;
+    bool csr_cache = false;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "-j" && i + 1 < argc) jobs = stoi(argv[++i]);
+        else if (a == "--socket" && i + 1 < argc) socket_path = argv[++i];
+        else if (a == "--cache-mb" && i + 1 < argc) cache_mb = stod(argv[++i]);
+        else if (a == "--cache") csr_cache = true;
+        else { print_usage(); return 1; }
+    }
+    if (jobs <= 0) jobs = max(1, (int)thread::hardware_concurrency());
+    signal(SIGPIPE, SIG_IGN);   // un cliente que cierra no debe matar al servidor
+
+    Server srv((size_t)(cache_mb * 1048576.0));
+    srv.csr_cache = csr_cache;
+    vector<thread> pool;
+    for (int i = 0; i < jobs; ++i) pool.emplace_back([&] { srv.worker(); });
+
+    if (socket_path.empty()) {
+        read_lines(srv, 0, make_shared<Sink>(1, false));
+    } else {
+        int ls = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (ls < 0 || socket_path.size() >= sizeof addr.sun_path) {
+            cerr << "No se pudo crear el socket " << socket_path << "\n";
+            return 1;
+        }
+        strncpy(addr.sun_path, socket_path.c_str(), sizeof addr.sun_path - 1);
+        ::unlink(socket_path.c_str());
+        if (::bind(ls, (sockaddr*)&addr, sizeof addr) < 0 || ::listen(ls, 64) < 0) {
+            cerr << "No se pudo escuchar en " << socket_path << "\n";
+            return 1;
+        }
+        cerr << "Escuchando en " << socket_path << " (" << jobs << " hilos)\n";
+        // Un hilo lector (desprendido) por conexión; shutdown desde cualquiera cierra el
+        // socket de escucha y corta la lectura de las demás conexiones (sus trabajos ya
+        // encolados terminan). conns lleva las conexiones abiertas: al salir se espera a que
+        // quede vacía, así un servidor de larga vida no acumula hilos terminados.
+        atomic<bool> stop{false};
+        mutex conn_mu;
+        condition_variable conn_cv;
+        vector<int> conns;
+        while (!stop) {
+            int c = ::accept(ls, nullptr, nullptr);
+            if (c < 0) break;
+            {
+                lock_guard<mutex> lk(conn_mu);
+                conns.push_back(c);
+            }
+            try {
+                thread([&, c] {
+                    auto out = make_shared<Sink>(c, true);   // lo cierra el último trabajo que escribe
+                    const bool more = read_lines(srv, c, out);
+                    if (!more && !stop.exchange(true)) ::shutdown(ls, SHUT_RDWR);   // destraba accept
+                    // Fuera de conns antes de soltar out (que puede cerrar c); después de
+                    // notificar el hilo ya no toca nada de main.
+                    lock_guard<mutex> lk(conn_mu);
+                    conns.erase(find(conns.begin(), conns.end(), c));
+                    conn_cv.notify_all();
+                }).detach();
+            } catch (const system_error& e) {
+                cerr << "No se pudo atender una conexión: " << e.what() << "\n";
+                lock_guard<mutex> lk(conn_mu);
+                conns.erase(find(conns.begin(), conns.end(), c));
+                ::close(c);
+            }
+        }
+        {
+            unique_lock<mutex> lk(conn_mu);
+            for (int c : conns) ::shutdown(c, SHUT_RD);
+            conn_cv.wait(lk, [&] { return conns.empty(); });
+        }
+        ::close(ls);
+        ::unlink(socket_path.c_str());
+    }
+
+    srv.close();
+    for (auto& t : pool) t.join();
+    return 0;
+}
@@ -0,0 +1,111 @@
+// solution.hpp
+// Soluciones como archivo y su verificación.
+//
+// Formato (--out de IterativeLocalSearch, --init y verificar): ids de vértices 0-based
+// separados por espacios o saltos de línea; las líneas que empiezan con # son comentarios.
+//
+// verify_solution usa las operaciones por palabra de cada backend (graph.hpp): un
+// VertexBitset con S, una pasada G.first_in(u, S) por u ∈ S (AND de filas en BitGraph,
+// pruebas de bit sobre la lista de u en CSR) y, para la maximalidad, S ∪ N(S) marcado con
+// mark_neighbors y contado con popcount. En CSR cuesta O(|S| + suma de grados de S + n/64):
+// milisegundos aun con millones de aristas, sin recorrer el grafo completo.
+
+#pragma once
+
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "graph.hpp"
+
+struct Verification {
+    bool ok = false;         // ids en rango, sin repetidos y sin aristas dentro de S
+    int bad_vertex = -1;     // id fuera de rango o repetido
+    int conflict_u = -1;     // arista (conflict_u, conflict_v) con ambos extremos en S
+    int conflict_v = -1;
+    int free_vertices = 0;   // vértices fuera de S sin vecinos en S (0 = maximal)
+
+    std::string message() const {
+        if (bad_vertex >= 0) return "vértice " + std::to_string(bad_vertex) + " fuera de rango o repetido";
+        if (conflict_u >= 0)
+            return "arista " + std::to_string(conflict_u) + " " + std::to_string(conflict_v) + " dentro de la solución";
+        return free_vertices ? "independiente, no maximal (" + std::to_string(free_vertices) + " vértices libres)"
+                             : "independiente y maximal";
+    }
+};
+
+template <class Graph>
+Verification verify_solution(const Graph& G, const std::vector<int>& S) {
+    Verification r;
+    VertexBitset in;
+    in.assign(G.n);
+    for (int u : S) {
+        if (u < 0 || u >= G.n || in.test(u)) { r.bad_vertex = u; return r; }
+        in.set(u);
+    }
+    for (int u : S) {
+        int v = G.first_in(u, in);
+        if (v >= 0) { r.conflict_u = u; r.conflict_v = v; return r; }
+    }
+    r.ok = true;
+    VertexBitset cov = in;
+    for (int u : S) G.mark_neighbors(u, cov);
+    long long covered = 0;
+    for (uint64_t x : cov.w) covered += std::popcount(x);
+    r.free_vertices = G.n - (int)covered;
+    return r;
+}
+
+// Lee ids de path. Devuelve false (con err) si no se puede abrir o hay texto que no es id.
+inline bool read_solution(const std::string& path, std::vector<int>& S, std::string& err) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) { err = "no se pudo abrir " + path; return false; }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    const std::string text = ss.str();
+    S.clear();
+    const char* p = text.c_str();
+    int line = 1;
+    while (*p) {
+        if (*p == '\n') { ++line; ++p; continue; }
+        if (*p == ' ' || *p == '\t' || *p == '\r' || *p == ',') { ++p; continue; }
+        if (*p == '#') { while (*p && *p != '\n') ++p; continue; }
+        char* end = nullptr;
+        errno = 0;
+        long v = std::strtol(p, &end, 10);
+        if (end == p || errno || v < 0 || v > INT32_MAX) {
+            err = path + ":" + std::to_string(line) + ": se esperaba un id de vértice";
+            return false;
+        }
+        S.push_back((int)v);
+        p = end;
+    }
+    return true;
+}
+
+// Escribe S (un id por línea) precedido por las líneas de comentario de header. Vía archivo
+// temporal + rename, como la caché: un corte no deja una solución a medias.
+inline bool write_solution(const std::string& path, const std::vector<int>& S, const std::string& header) {
+    const std::string tmp = path + ".tmp" + std::to_string((long long)::getpid());
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) return false;
+        std::istringstream h(header);
+        for (std::string l; std::getline(h, l);) out << "# " << l << "\n";
+        std::string buf;
+        for (int v : S) { buf += std::to_string(v); buf += '\n'; }
+        out << buf;
+        out.flush();
+        if (!out) { out.close(); std::remove(tmp.c_str()); return false; }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) { std::remove(tmp.c_str()); return false; }
+    return true;
+}
@@ -1,44 +1,18 @@
 #include <bits/stdc++.h>
 #include <iostream>
+#include "graph.hpp"
+#include "greedy.hpp"
+#include "reduce.hpp"
 using namespace std;
 using namespace chrono;
 
 // =====================
-// Estructura de Grafo
+// Greedy determinista con heap perezoso (versión original, para --bench)
 // =====================
-struct Graph {
-    int n;
-    vector<vector<int>> adj;
-};
-
-// =====================
-// Lectura del grafo
-// =====================
-Graph readGraph(const string &filename) {
-    ifstream in(filename);
-    if (!in.is_open()) {
-        cerr << "No se pudo abrir archivo " << filename << endl;
-        exit(1);
-    }
-    int n;
-    in >> n;
-    Graph G;
-    G.n = n;
-    G.adj.assign(n, {});
-    int u, v;
-    while (in >> u >> v) {
-        G.adj[u].push_back(v);
-        G.adj[v].push_back(u);
-    }
-    return G;
-}
-
-// =====================
-// Greedy determinista
-// =====================
-int greedy(const Graph &G) {
+template <class Graph>
+int greedy_heap(const Graph &G) {
     vector<int> degree(G.n);
-    for (int i = 0; i < G.n; i++) degree[i] = G.adj[i].size();
+    for (int i = 0; i < G.n; i++) degree[i] = G.degree(i);
     vector<bool> removed(G.n, false);
     priority_queue<pair<int,int>, vector<pair<int,int>>, greater<>> pq;
     for (int i = 0; i < G.n; i++) pq.push({degree[i], i});
@@ -48,10 +22,10 @@ int greedy(const Graph &G) {
         if (removed[u] || degree[u] != d) continue;
         count++;
         removed[u] = true;
-        for (int v : G.adj[u]) {
+        for (int v : G.neighbors(u)) {
             if (!removed[v]) {
                 removed[v] = true;
-                for (int w : G.adj[v]) {
+                for (int w : G.neighbors(v)) {
                     if (!removed[w]) {
                         degree[w]--;
                         pq.push({degree[w], w});
@@ -63,25 +37,88 @@ int greedy(const Graph &G) {
     return count;
 }
 
+// =====================
+// Benchmark: greedy_heap vs greedy
+// =====================
+// Una línea CSV por instancia con la mediana de reps corridas de cada versión. Al final
+// agrega un grafo disperso grande generado en memoria (200000 vértices, 4000 aristas): casi
+// todos comparten grado 0, el caso en que el desempate por id no puede recorrer el bloque.
+template <class F>
+double median_time(int reps, F &&f) {
+    vector<double> ts;
+    for (int r = 0; r < reps; r++) {
+        auto start = high_resolution_clock::now();
+        f();
+        auto end = high_resolution_clock::now();
+        ts.push_back(duration<double>(end - start).count());
+    }
+    sort(ts.begin(), ts.end());
+    return ts[ts.size() / 2];
+}
+
+int run_bench(int reps, const vector<string> &files) {
+    cout << "archivo,n,m,densidad,sol_heap,sol_bucket,t_heap,t_bucket,speedup" << endl;
+    int rc = 0;
+    auto compare = [&](const string &name, const auto &G) {
+        int s_heap = 0, s_bucket = 0;
+        double t_heap = median_time(reps, [&] { s_heap = greedy_heap(G); });
+        double t_bucket = median_time(reps, [&] { s_bucket = greedy(G); });
+        double dens = G.n > 1 ? 2.0 * G.m / ((double)G.n * (G.n - 1)) : 0.0;
+        cout << name << "," << G.n << "," << G.m << "," << dens << ","
+             << s_heap << "," << s_bucket << "," << t_heap << "," << t_bucket << ","
+             << (t_bucket > 0 ? t_heap / t_bucket : 0.0) << endl;
+        if (s_heap != s_bucket) {
+            cerr << "Soluciones distintas en " << name << endl;
+            rc = 2;
+        }
+    };
+    for (const string &f : files) {
+        bool ok = with_loaded_graph(f, [&](const auto &G) { compare(f, G); });
+        if (!ok) {
+            cerr << "No se pudo abrir archivo " << f << endl;
+            rc = 1;
+        }
+    }
+
+    const int N = 200000, M = 4000;
+    mt19937_64 gen(1);
+    uniform_int_distribution<int> pick(0, N - 1);
+    vector<vector<int>> parts(1);
+    for (int e = 0; e < M; e++) { parts[0].push_back(pick(gen)); parts[0].push_back(pick(gen)); }
+    Graph32 G;
+    G.build(N, parts);
+    compare("disperso_n200000_m4000", G);
+    return rc;
+}
+
 // =====================
 // MAIN
 // =====================
 int main(int argc, char* argv[]) {
+    if (argc >= 4 && string(argv[1]) == "--bench") {
+        return run_bench(max(1, stoi(argv[2])), vector<string>(argv + 3, argv + argc));
+    }
     if (argc < 3 || string(argv[1]) != "-i") {
-        cerr << "Uso: ./greed -i <instancia>" << endl;
+        cerr << "Uso: ./greed -i <instancia> [--reduce]" << endl;
+        cerr << "     ./greed --bench <reps> <instancia>..." << endl;
         return 1;
     }
 
     string filename = argv[2];
-    Graph G = readGraph(filename);
-
-    auto start = high_resolution_clock::now();
-    int sol = greedy(G);
-    auto end = high_resolution_clock::now();
-    double t = duration<double>(end - start).count();
+    bool reduce = argc > 3 && string(argv[3]) == "--reduce";
+    bool ok = with_reduced_graph(filename, [&](const auto &G, const Reduction &R) {
+        auto start = high_resolution_clock::now();
+        int sol = R.offset + greedy(G);
+        auto end = high_resolution_clock::now();
+        double t = duration<double>(end - start).count();
 
-    cout << "Solucion: " << sol << endl;
-    cout << "Tiempo: " << t << " segundos" << endl;
+        cout << "Solucion: " << sol << endl;
+        cout << "Tiempo: " << t << " segundos" << endl;
+    }, GraphBackend::Auto, 0, false, reduce);
+    if (!ok) {
+        cerr << "No se pudo abrir archivo " << filename << endl;
+        return 1;
+    }
 
     return 0;
 }
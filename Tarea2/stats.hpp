@@ -0,0 +1,172 @@
+// stats.hpp
+// Estadísticas en una pasada para los resúmenes por densidad (batch y estadisticas_por_densidad).
+//   - RunningStats: media y varianza de Welford (estable numéricamente, a diferencia de
+//     sum(x^2) - n*media^2) y combinación de acumuladores parciales con la fórmula de Chan,
+//     para sumar resultados de varios archivos o hilos sin volver a recorrer los datos.
+//   - quantile: cuantil con interpolación lineal (tipo 7, como R/NumPy) sobre datos ordenados.
+//   - average_ranks / FriedmanTest: test de Friedman por bloques con corrección por empates y
+//     comparación post-hoc de Conover contra el mejor (lo que usa la carrera de calibrar).
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+struct RunningStats {
+    long long n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;   // suma de cuadrados de desvíos
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double x) {
+        ++n;
+        const double d = x - mean;
+        mean += d / (double)n;
+        m2 += d * (x - mean);
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+
+    void merge(const RunningStats& o) {
+        if (o.n == 0) return;
+        if (n == 0) { *this = o; return; }
+        const double N = (double)(n + o.n);
+        const double d = o.mean - mean;
+        mean += d * (double)o.n / N;
+        m2 += o.m2 + d * d * (double)n * (double)o.n / N;
+        n += o.n;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+    }
+
+    // Varianza muestral (n - 1); 0 con menos de dos datos.
+    double variance() const { return n > 1 ? m2 / (double)(n - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+};
+
+// x debe venir ordenado.
+inline double quantile(const std::vector<double>& x, double q) {
+    if (x.empty()) return 0.0;
+    const double pos = q * (double)(x.size() - 1);
+    const size_t i = (size_t)pos;
+    if (i + 1 >= x.size()) return x.back();
+    return x[i] + (pos - (double)i) * (x[i + 1] - x[i]);
+}
+
+// Rangos 1..k de x (1 = mayor valor si higher_better); los empates reciben el promedio.
+inline std::vector<double> average_ranks(const std::vector<double>& x, bool higher_better = true) {
+    const size_t k = x.size();
+    std::vector<size_t> idx(k);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return higher_better ? x[a] > x[b] : x[a] < x[b]; });
+    std::vector<double> r(k);
+    for (size_t i = 0; i < k;) {
+        size_t j = i;
+        while (j + 1 < k && x[idx[j + 1]] == x[idx[i]]) ++j;
+        const double avg = (double)(i + j) / 2.0 + 1.0;
+        for (size_t t = i; t <= j; ++t) r[idx[t]] = avg;
+        i = j + 1;
+    }
+    return r;
+}
+
+// P(X > x) para X ~ chi^2 con k grados de libertad (gamma incompleta regularizada Q(k/2, x/2):
+// serie si x < a + 1, fracción continua si no).
+inline double chi2_sf(double x, double k) {
+    if (x <= 0.0) return 1.0;
+    const double a = k / 2.0, z = x / 2.0;
+    const double lg = std::lgamma(a);
+    if (z < a + 1.0) {
+        double sum = 1.0 / a, term = sum;
+        for (int n = 1; n < 500; ++n) {
+            term *= z / (a + n);
+            sum += term;
+            if (term < sum * 1e-15) break;
+        }
+        return std::max(0.0, 1.0 - sum * std::exp(-z + a * std::log(z) - lg));
+    }
+    const double tiny = 1e-300;
+    double b = z + 1.0 - a, c = 1.0 / tiny, d = 1.0 / b, h = d;
+    for (int i = 1; i < 500; ++i) {
+        const double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b; if (std::fabs(d) < tiny) d = tiny;
+        c = b + an / c; if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        const double del = d * c;
+        h *= del;
+        if (std::fabs(del - 1.0) < 1e-15) break;
+    }
+    return std::min(1.0, std::exp(-z + a * std::log(z) - lg) * h);
+}
+
+// Cuantil p de la t de Student con df grados de libertad (expansión de Cornish-Fisher
+// sobre el cuantil normal; error < 1e-3 para df >= 3, suficiente para un umbral de descarte).
+inline double t_quantile(double p, double df) {
+    // Cuantil normal (Acklam).
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    double z;
+    if (p < 0.02425) {
+        const double q = std::sqrt(-2 * std::log(p));
+        z = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    } else if (p > 1 - 0.02425) {
+        const double q = std::sqrt(-2 * std::log(1 - p));
+        z = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    } else {
+        const double q = p - 0.5, r = q * q;
+        z = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+    }
+    const double z3 = z * z * z, z5 = z3 * z * z, z7 = z5 * z * z;
+    return z + (z3 + z) / (4 * df) + (5 * z5 + 16 * z3 + 3 * z) / (96 * df * df) +
+           (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * df * df * df);
+}
+
+// Test de Friedman sobre b bloques (instancias) x k tratamientos (configuraciones), con la
+// forma de Conover que corrige empates. ranks[i][j] = rango de j en el bloque i (1 = mejor).
+// Si el test rechaza al nivel 1 - confidence, worse_than_best(j) dice si j es
+// significativamente peor que el de menor suma de rangos (post-hoc de Conover).
+struct FriedmanTest {
+    int b = 0, k = 0;
+    std::vector<double> R;   // suma de rangos por tratamiento
+    double p_value = 1.0;
+    double crit = 0.0;       // diferencia mínima de sumas de rangos para descartar
+    int best = 0;
+
+    void run(const std::vector<std::vector<double>>& ranks, double confidence) {
+        b = (int)ranks.size();
+        k = b ? (int)ranks[0].size() : 0;
+        R.assign(k, 0.0);
+        double A = 0.0;
+        for (const auto& row : ranks)
+            for (int j = 0; j < k; ++j) { R[j] += row[j]; A += row[j] * row[j]; }
+        best = (int)(std::min_element(R.begin(), R.end()) - R.begin());
+        p_value = 1.0;
+        crit = std::numeric_limits<double>::infinity();
+        if (b < 2 || k < 2) return;
+        const double C = b * k * (k + 1.0) * (k + 1.0) / 4.0;
+        double SR = 0.0;
+        for (double r : R) SR += r * r;
+        if (A - C <= 1e-12) return;   // todo empatado
+        const double T = (k - 1) * (SR - b * C) / (A - C);
+        p_value = chi2_sf(T, k - 1);
+        if (p_value >= 1.0 - confidence) return;
+        const double df = (b - 1.0) * (k - 1.0);
+        const double var = 2.0 * (b * A - SR) / df;
+        crit = t_quantile(1.0 - (1.0 - confidence) / 2.0, df) * std::sqrt(std::max(0.0, var));
+    }
+    bool worse_than_best(int j) const { return R[j] - R[best] > crit; }
+};
@@ -0,0 +1,136 @@
+// trace.hpp
+// Traza de convergencia del ILS: un evento por iteración en un buffer circular por walker.
+//
+// Con --trace <archivo> cada walker anota, por iteración, el instante (ns desde el inicio
+// del Timer), el tamaño de la solución actual, los movimientos de la LS (agregar un libre
+// vs. swap 1-por-2), el tamaño de la perturbación y banderas (aceptada, mejora del walker,
+// nuevo incumbente global, reinicio). El buffer es de capacidad fija: si se llena se
+// pisan los eventos más viejos y se cuentan como descartados. Se vuelca al terminar.
+//
+// Compilar con -DMISP_TRACE=0 elimina la instrumentación por completo.
+//
+// Formatos de salida:
+//   - *.csv: walker,iter,t_ns,size,adds,swaps,perturb,flags
+//   - otro:  binario little-endian
+//              TraceFileHeader | por walker: TraceWalkerHeader | TraceEvent[count]
+
+#pragma once
+
+#ifndef MISP_TRACE
+#define MISP_TRACE 1
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum TraceFlag : uint8_t {
+    kTraceAccepted = 1,   // el candidato reemplazó a la solución actual
+    kTraceImproved = 2,   // mejor solución del walker
+    kTraceIncumbent = 4,  // nueva mejor solución global (BEST)
+    kTraceRestart = 8,    // el walker reinició desde la élite
+};
+
+struct TraceEvent {
+    uint64_t t_ns;
+    uint64_t iter;        // 0 = construcción inicial + LS
+    int32_t size;         // |S| actual tras aceptar o deshacer
+    uint16_t adds;        // movimientos de LS: agregar un vértice libre
+    uint16_t swaps;       // movimientos de LS: (1,2)-swap
+    uint16_t perturb;     // vértices quitados por la perturbación
+    uint8_t flags;        // TraceFlag
+    uint8_t pad[5];
+};
+static_assert(sizeof(TraceEvent) == 32, "TraceEvent debe medir 32 bytes");
+
+constexpr char kTraceMagic[8] = {'M', 'I', 'S', 'P', 'T', 'R', 'C', '\0'};
+constexpr uint32_t kTraceVersion = 1;
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t walkers;
+};
+
+struct TraceWalkerHeader {
+    uint32_t walker;
+    uint32_t pad;
+    uint64_t count;       // eventos que siguen
+    uint64_t dropped;     // eventos pisados por el buffer circular
+};
+
+// Buffer circular de un walker. Solo lo escribe su hilo; se lee al terminar.
+struct TraceRing {
+    std::unique_ptr<TraceEvent[]> buf;   // sin inicializar: las páginas se tocan al usarse
+    uint64_t mask = 0;
+    uint64_t head = 0;                    // eventos anotados en total
+
+    void init(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        buf.reset(new TraceEvent[cap]);
+        mask = cap - 1;
+        head = 0;
+    }
+    void push(const TraceEvent& e) { buf[head & mask] = e; ++head; }
+    uint64_t count() const { return head < mask + 1 ? head : mask + 1; }
+    uint64_t dropped() const { return head - count(); }
+    // i-ésimo evento conservado, en orden cronológico.
+    const TraceEvent& at(uint64_t i) const { return buf[(head - count() + i) & mask]; }
+};
+
+struct Trace {
+    std::vector<TraceRing> rings;
+
+    Trace(int walkers, size_t capacity) : rings(walkers) {
+        for (auto& r : rings) r.init(capacity);
+    }
+
+    uint64_t dropped() const {
+        uint64_t d = 0;
+        for (const auto& r : rings) d += r.dropped();
+        return d;
+    }
+
+    bool write(const std::string& path) const {
+        const bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        std::ofstream out(path, csv ? std::ios::out : std::ios::binary);
+        if (!out) return false;
+        if (csv) {
+            out << "walker,iter,t_ns,size,adds,swaps,perturb,flags\n";
+            char line[160];
+            for (size_t w = 0; w < rings.size(); ++w) {
+                const TraceRing& r = rings[w];
+                for (uint64_t i = 0; i < r.count(); ++i) {
+                    const TraceEvent& e = r.at(i);
+                    int len = std::snprintf(line, sizeof line, "%zu,%llu,%llu,%d,%u,%u,%u,%u\n", w,
+                                            (unsigned long long)e.iter, (unsigned long long)e.t_ns,
+                                            e.size, e.adds, e.swaps, e.perturb, e.flags);
+                    out.write(line, len);
+                }
+            }
+        } else {
+            TraceFileHeader h{};
+            std::memcpy(h.magic, kTraceMagic, 8);
+            h.version = kTraceVersion;
+            h.walkers = (uint32_t)rings.size();
+            out.write((const char*)&h, sizeof h);
+            for (size_t w = 0; w < rings.size(); ++w) {
+                const TraceRing& r = rings[w];
+                TraceWalkerHeader wh{(uint32_t)w, 0, r.count(), r.dropped()};
+                out.write((const char*)&wh, sizeof wh);
+                // Dos tramos contiguos del buffer circular.
+                const uint64_t cap = r.mask + 1, first = (r.head - r.count()) & r.mask;
+                const uint64_t n1 = std::min<uint64_t>(r.count(), cap - first);
+                out.write((const char*)&r.buf[first], (std::streamsize)(n1 * sizeof(TraceEvent)));
+                out.write((const char*)&r.buf[0], (std::streamsize)((r.count() - n1) * sizeof(TraceEvent)));
+            }
+        }
+        return (bool)out;
+    }
+};
@@ -0,0 +1,82 @@
+// verificar.cpp
+// Verificación independiente de soluciones: lee la instancia (o su caché .csr) y uno o más
+// archivos de solución (formato de solution.hpp, p. ej. los de --out) y revisa, en ids
+// originales, que no haya ids fuera de rango ni repetidos, que no haya aristas dentro de la
+// solución y cuántos vértices quedan libres (0 = maximal).
+//
+// Salida, una línea por archivo:
+//   OK <archivo> <tamaño> MAXIMAL|LIBRES <k>
+//   ERROR <archivo> <motivo>
+// Código de salida 0 si todas son independientes, 1 si alguna no lo es o no se pudo leer.
+//
+// Compilar (Linux):
+//   g++ -O3 -march=native -std=c++20 -Wall -Wextra -pthread -o verificar verificar.cpp
+//
+// Ejecutar:
+//   ./verificar -i new_3000_dataset/erdos_n3000_p0c0.1_1.graph hoy.sol
+//   ./verificar -i instancia.graph --cache --verbose 1 a.sol b.sol c.sol
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "ils.hpp"
+#include "solution.hpp"
+
+using namespace std;
+
+static void print_usage() {
+    cerr << "Uso: verificar -i <instancia> [--cache] [--verbose 0/1] <solucion> [<solucion> ...]\n"
+            "  Cada solucion: ids 0-based separados por espacios o lineas (# = comentario).\n";
+}
+
+int main(int argc, char** argv) {
+    string instance;
+    vector<string> files;
+    bool cache = false;
+    int verbose = 0;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "-i" && i + 1 < argc) instance = argv[++i];
+        else if (a == "--cache") cache = true;
+        else if (a == "--verbose" && i + 1 < argc) verbose = stoi(argv[++i]);
+        else if (!a.empty() && a[0] == '-') { print_usage(); return 1; }
+        else files.push_back(a);
+    }
+    if (instance.empty() || files.empty()) { print_usage(); return 1; }
+
+    int rc = 0;
+    Timer tl;
+    bool loaded = with_loaded_csr(instance, [&](auto& G) {
+        if (verbose)
+            cerr << "# Vertices: " << G.n << "  Edges: " << G.m << "  carga " << fixed << setprecision(3)
+                 << tl.elapsed() << " s\n";
+        for (const string& f : files) {
+            vector<int> S;
+            string err;
+            if (!read_solution(f, S, err)) {
+                cout << "ERROR " << f << " " << err << "\n";
+                rc = 1;
+                continue;
+            }
+            Timer tv;
+            const Verification v = verify_solution(G, S);
+            if (!v.ok) {
+                cout << "ERROR " << f << " " << v.message() << "\n";
+                rc = 1;
+            } else {
+                cout << "OK " << f << " " << S.size();
+                if (v.free_vertices) cout << " LIBRES " << v.free_vertices << "\n";
+                else cout << " MAXIMAL\n";
+            }
+            if (verbose) cerr << "# " << f << ": " << fixed << setprecision(6) << tv.elapsed() << " s\n";
+        }
+    }, 0, cache);
+    if (!loaded) {
+        cerr << "Error leyendo instancia: " << instance << "\n";
+        return 1;
+    }
+    return rc;
+}